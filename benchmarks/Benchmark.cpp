@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+/*
+  Measures the throughput and latency of deserializing and serializing
+  executables of various shapes through the different sources and sinks
+  supported by the library. Every case runs in a separate child process, so
+  that the peak resident set size reported for it is its own.
+
+  Usage: sharemind-executable-benchmark [--min-time SECONDS] [FILTER ...]
+
+  Only cases whose names contain any of the given filters are run.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../src/Executable.h"
+
+
+namespace {
+
+std::atomic<std::size_t> numAllocations(0u);
+
+void * countedAllocate(std::size_t size) {
+    numAllocations.fetch_add(1u, std::memory_order_relaxed);
+    if (auto const ptr = std::malloc(size ? size : 1u))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void * countedAllocate(std::size_t size, std::align_val_t alignment) {
+    numAllocations.fetch_add(1u, std::memory_order_relaxed);
+    auto const align = static_cast<std::size_t>(alignment);
+    if (auto const ptr =
+            std::aligned_alloc(align, (size + align - 1u) & ~(align - 1u)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+} // anonymous namespace
+
+void * operator new(std::size_t size) { return countedAllocate(size); }
+void * operator new[](std::size_t size) { return countedAllocate(size); }
+void * operator new(std::size_t size, std::align_val_t alignment)
+{ return countedAllocate(size, alignment); }
+void * operator new[](std::size_t size, std::align_val_t alignment)
+{ return countedAllocate(size, alignment); }
+void operator delete(void * ptr) noexcept { std::free(ptr); }
+void operator delete[](void * ptr) noexcept { std::free(ptr); }
+void operator delete(void * ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void * ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void * ptr, std::align_val_t) noexcept
+{ std::free(ptr); }
+void operator delete[](void * ptr, std::align_val_t) noexcept
+{ std::free(ptr); }
+void operator delete(void * ptr, std::size_t, std::align_val_t) noexcept
+{ std::free(ptr); }
+void operator delete[](void * ptr, std::size_t, std::align_val_t) noexcept
+{ std::free(ptr); }
+
+namespace {
+
+using sharemind::Executable;
+using Clock = std::chrono::steady_clock;
+
+struct Shape {
+    char const * name;
+    std::size_t numLinkingUnits;
+    std::size_t numInstructions;
+    std::size_t roDataSize;
+    std::size_t numSyscallBindings;
+    std::size_t numPdBindings;
+};
+
+Shape const shapes[] = {
+    { "tiny",          1u,                 16u,        64u,      4u,     1u },
+    { "many-lus",    256u,                 16u,        64u,      4u,     1u },
+    { "huge",          1u, 8u * 1024u * 1024u, 64u << 20u,      4u,     1u },
+    { "bindings",      1u,                 16u,        64u, 100000u, 20000u }
+};
+
+Executable makeExecutable(Shape const & shape, std::size_t formatVersion) {
+    Executable r;
+    r.fileFormatVersion = formatVersion;
+    r.linkingUnits.resize(shape.numLinkingUnits);
+    for (auto & lu : r.linkingUnits) {
+        Executable::TextSection::Container instructions(shape.numInstructions);
+        for (std::size_t i = 0u; i < instructions.size(); ++i)
+            instructions[i].uint64[0] = i;
+        lu.textSection =
+                std::make_shared<Executable::TextSection>(
+                    std::move(instructions));
+
+        std::vector<char> roData(shape.roDataSize);
+        for (std::size_t i = 0u; i < roData.size(); ++i)
+            roData[i] = static_cast<char>(i * 31u);
+        lu.roDataSection =
+                std::make_shared<Executable::DataSection>(
+                    roData.data(),
+                    roData.size(),
+                    Executable::DataSection::CopyData);
+        lu.rwDataSection =
+                std::make_shared<Executable::DataSection>(
+                    roData.data(),
+                    std::min(roData.size(), static_cast<std::size_t>(64u)),
+                    Executable::DataSection::CopyData);
+        lu.bssSection = std::make_shared<Executable::BssSection>(1024u);
+
+        lu.syscallBindingsSection =
+                std::make_shared<Executable::SyscallBindingsSection>();
+        auto & syscalls = lu.syscallBindingsSection->syscallBindings;
+        for (std::size_t i = 0u; i < shape.numSyscallBindings; ++i)
+            syscalls.push_back("sharemind_benchmark_syscall_"
+                               + std::to_string(i));
+        lu.pdBindingsSection =
+                std::make_shared<Executable::PdBindingsSection>();
+        auto & pds = lu.pdBindingsSection->pdBindings;
+        for (std::size_t i = 0u; i < shape.numPdBindings; ++i)
+            pds.push_back("pd_benchmark_" + std::to_string(i));
+    }
+    return r;
+}
+
+std::string serialize(Executable const & executable) {
+    std::string r(executable.serializeTo(nullptr, 0u), '\0');
+    executable.serializeTo(&r[0u], r.size());
+    return r;
+}
+
+void writeAll(int fd, char const * data, std::size_t size) {
+    while (size) {
+        auto const r = ::write(fd, data, size);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        data += r;
+        size -= static_cast<std::size_t>(r);
+    }
+}
+
+void drain(int fd) {
+    char buffer[64u * 1024u];
+    for (;;) {
+        auto const r = ::read(fd, buffer, sizeof(buffer));
+        if (r == 0 || (r < 0 && errno != EINTR))
+            return;
+    }
+}
+
+/*
+  Optionally closes the given file descriptor, and then joins the given
+  thread, when destroyed, so that the thread is joined also when an exception
+  is thrown:
+*/
+class ThreadJoinGuard {
+
+public: /* Methods: */
+
+    ThreadJoinGuard(std::thread & thread, int closeFd = -1) noexcept
+        : m_thread(thread)
+        , m_closeFd(closeFd)
+    {}
+
+    ThreadJoinGuard(ThreadJoinGuard const &) = delete;
+    ThreadJoinGuard & operator=(ThreadJoinGuard const &) = delete;
+
+    ~ThreadJoinGuard() noexcept {
+        if (m_closeFd >= 0)
+            ::close(m_closeFd);
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+private: /* Fields: */
+
+    std::thread & m_thread;
+    int const m_closeFd;
+
+};
+
+void loadFromPipe(std::string const & image, Executable & executable) {
+    int fds[2];
+    if (::pipe(fds) != 0)
+        throw std::runtime_error("pipe() failed!");
+    std::thread writer(
+                [&image, fd = fds[1]]() {
+                    writeAll(fd, image.data(), image.size());
+                    ::close(fd);
+                });
+    bool loaded;
+    {
+        /* The stream is closed before the writer is joined, so that the
+           writer does not block on a pipe which is no longer read: */
+        ThreadJoinGuard const guard(writer);
+        std::ifstream is("/dev/fd/" + std::to_string(fds[0]),
+                         std::ios::binary);
+        ::close(fds[0]);
+        is >> executable;
+        loaded = static_cast<bool>(is);
+    }
+    if (!loaded)
+        throw std::runtime_error("Failed to load from pipe!");
+}
+
+void storeToPipe(Executable const & executable) {
+    int fds[2];
+    if (::pipe(fds) != 0)
+        throw std::runtime_error("pipe() failed!");
+    std::thread reader([fd = fds[0]]() { drain(fd); ::close(fd); });
+    ThreadJoinGuard const guard(reader, fds[1]);
+    executable.serializeToFileDescriptor(fds[1]);
+}
+
+std::string concatName(bool isLoad,
+                       char const * kind,
+                       Shape const & shape,
+                       std::size_t formatVersion)
+{
+    return std::string(isLoad ? "load/" : "store/") + kind + '/' + shape.name
+           + "/v" + std::to_string(formatVersion);
+}
+
+struct Case {
+    std::string name;
+    Shape const * shape;
+    std::size_t formatVersion;
+    bool isLoad;
+    std::function<void (Executable const &, std::string const &)> run;
+};
+
+std::string temporaryFilename() {
+    char const * const tmpDir = std::getenv("TMPDIR");
+    return std::string(tmpDir ? tmpDir : "/tmp")
+           + "/sharemind-executable-benchmark."
+           + std::to_string(::getpid());
+}
+
+/*
+  Makes all cases. Loading from a std::ifstream reads the given file, and
+  storing to a std::ofstream writes to the given file with an ".out" suffix:
+*/
+std::vector<Case> makeCases(std::string const & tmp) {
+    std::vector<Case> r;
+    for (auto const & shape : shapes) {
+        for (std::size_t formatVersion : {0u, 1u}) {
+            auto const add =
+                    [&](char const * kind, bool isLoad, auto run) {
+                        r.push_back(
+                            Case{concatName(isLoad, kind, shape, formatVersion),
+                                 &shape,
+                                 formatVersion,
+                                 isLoad,
+                                 std::move(run)});
+                    };
+            add("buffer", true,
+                [](Executable const &, std::string const & image) {
+                    Executable e;
+                    e.deserializeFrom(image.data(), image.size());
+                });
+            add("istringstream", true,
+                [](Executable const &, std::string const & image) {
+                    std::istringstream is(image);
+                    Executable e;
+                    if (!(is >> e))
+                        throw std::runtime_error("Failed to load!");
+                });
+            add("ifstream", true,
+                [tmp](Executable const &, std::string const &) {
+                    std::ifstream is(tmp, std::ios::binary);
+                    Executable e;
+                    if (!(is >> e))
+                        throw std::runtime_error("Failed to load!");
+                });
+            add("pipe", true,
+                [](Executable const &, std::string const & image) {
+                    Executable e;
+                    loadFromPipe(image, e);
+                });
+            add("buffer", false,
+                [](Executable const & e, std::string const & image) {
+                    std::string buffer(image.size(), '\0');
+                    e.serializeTo(&buffer[0u], buffer.size());
+                });
+            add("ostringstream", false,
+                [](Executable const & e, std::string const &) {
+                    std::ostringstream os;
+                    os << e;
+                });
+            add("ofstream", false,
+                [tmp](Executable const & e, std::string const &) {
+                    std::ofstream os(tmp + ".out", std::ios::binary);
+                    os << e;
+                });
+            add("pipe", false,
+                [](Executable const & e, std::string const &)
+                { storeToPipe(e); });
+        }
+    }
+    return r;
+}
+
+/* Runs the given case in the calling process and prints its results: */
+void runCase(Case const & c, std::string const & tmp, double minTime) {
+    auto const executable(makeExecutable(*c.shape, c.formatVersion));
+    auto const image(serialize(executable));
+    {
+        std::ofstream os(tmp, std::ios::binary);
+        os.write(image.data(), static_cast<std::streamsize>(image.size()));
+    }
+
+    c.run(executable, image); // Warm up
+
+    std::vector<double> latencies;
+    auto const allocationsBefore =
+            numAllocations.load(std::memory_order_relaxed);
+    auto const start = Clock::now();
+    double elapsed;
+    do {
+        auto const iterationStart = Clock::now();
+        c.run(executable, image);
+        auto const iterationEnd = Clock::now();
+        latencies.emplace_back(
+                    std::chrono::duration<double>(
+                        iterationEnd - iterationStart).count());
+        elapsed = std::chrono::duration<double>(iterationEnd - start).count();
+    } while (elapsed < minTime || latencies.size() < 3u);
+    auto const allocations =
+            numAllocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+    ::unlink(tmp.c_str());
+    ::unlink((tmp + ".out").c_str());
+
+    ::rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+
+    std::sort(latencies.begin(), latencies.end());
+    auto const iterations = latencies.size();
+    std::printf("%-32s %12zu %7zu %12.1f %12.1f %10.1f %10.1f %12ld\n",
+                c.name.c_str(),
+                image.size(),
+                iterations,
+                latencies[iterations / 2u] * 1e6,
+                latencies.front() * 1e6,
+                static_cast<double>(image.size()) * iterations / elapsed
+                / (1024.0 * 1024.0),
+                static_cast<double>(allocations) / iterations,
+                usage.ru_maxrss);
+    std::fflush(stdout);
+}
+
+} // anonymous namespace
+
+int main(int argc, char * argv[]) {
+    double minTime = 1.0;
+    std::vector<std::string> filters;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+            minTime = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--help")) {
+            std::printf("Usage: %s [--min-time SECONDS] [FILTER ...]\n",
+                        argv[0]);
+            return EXIT_SUCCESS;
+        } else {
+            filters.emplace_back(argv[i]);
+        }
+    }
+
+    /* Failed writes to pipes are reported as errors instead: */
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::printf("%-32s %12s %7s %12s %12s %10s %10s %12s\n",
+                "case",
+                "bytes",
+                "iters",
+                "median(us)",
+                "min(us)",
+                "MiB/s",
+                "allocs/op",
+                "maxrss(KiB)");
+    std::fflush(stdout);
+
+    auto const tmp = temporaryFilename();
+    int status = EXIT_SUCCESS;
+    for (auto const & c : makeCases(tmp)) {
+        if (!filters.empty()
+            && std::none_of(filters.begin(),
+                            filters.end(),
+                            [&c](std::string const & filter) {
+                                return c.name.find(filter)
+                                       != std::string::npos;
+                            }))
+            continue;
+
+        auto const pid = ::fork();
+        if (pid < 0) {
+            std::perror("fork()");
+            return EXIT_FAILURE;
+        }
+        if (pid == 0) {
+            try {
+                runCase(c, tmp, minTime);
+            } catch (std::exception const & e) {
+                std::fprintf(stderr, "%s: %s\n", c.name.c_str(), e.what());
+                std::fflush(stderr);
+                ::_exit(EXIT_FAILURE);
+            }
+            ::_exit(EXIT_SUCCESS);
+        }
+        int childStatus;
+        while (::waitpid(pid, &childStatus, 0) < 0 && errno == EINTR)
+            ;
+        if (!WIFEXITED(childStatus) || WEXITSTATUS(childStatus))
+            status = EXIT_FAILURE;
+    }
+    return status;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#include "CompactExecutable.h"
+
+#include <cstring>
+#include <limits>
+#include <new>
+#include "LargePageAllocator.h"
+
+
+namespace sharemind {
+namespace {
+
+using SectionType = CompactExecutable::SectionType;
+
+constexpr std::size_t const storageAlignment = alignof(std::max_align_t);
+
+std::size_t bindingsStorageSize(Executable::BindingsTable const & table) {
+    if (table.size()
+        > std::numeric_limits<std::size_t>::max() / sizeof(std::string_view))
+        throw std::bad_array_new_length();
+    auto const indexSize = table.size() * sizeof(std::string_view);
+    if (table.sizeInBytes() > std::numeric_limits<std::size_t>::max()
+                              - indexSize)
+        throw std::bad_array_new_length();
+    return indexSize + table.sizeInBytes();
+}
+
+/*
+  Calls f(type, storageSizeInBytes) for each section of the given linking
+  unit in the order of their section types:
+*/
+template <typename F>
+void forEachSection(Executable::LinkingUnit const & lu, F && f) {
+    if (lu.textSection)
+        f(SectionType::Text,
+          lu.textSection->instructions.size() * sizeof(SharemindCodeBlock));
+    if (lu.roDataSection)
+        f(SectionType::RoData, lu.roDataSection->sizeInBytes);
+    if (lu.rwDataSection)
+        f(SectionType::Data, lu.rwDataSection->sizeInBytes);
+    if (lu.bssSection)
+        f(SectionType::Bss, 0u);
+    if (lu.syscallBindingsSection)
+        f(SectionType::Bind,
+          bindingsStorageSize(lu.syscallBindingsSection->syscallBindings));
+    if (lu.pdBindingsSection)
+        f(SectionType::PdBind,
+          bindingsStorageSize(lu.pdBindingsSection->pdBindings));
+    if (lu.debugSection)
+        f(SectionType::Debug, lu.debugSection->sizeInBytes);
+}
+
+/*
+  Copies the given bindings to the given storage as an array of views
+  followed by the NUL-terminated bindings the views refer to:
+*/
+void copyBindings(Executable::BindingsTable const & table, void * dest)
+        noexcept
+{
+    auto const views = static_cast<std::string_view *>(dest);
+    auto const chars = reinterpret_cast<char *>(views + table.size());
+    if (table.sizeInBytes())
+        std::memcpy(chars, table.data(), table.sizeInBytes());
+    for (std::size_t i = 0u; i < table.size(); ++i) {
+        auto const binding = table[i];
+        new (views + i) std::string_view(
+                    chars + (binding.data() - table.data()),
+                    binding.size());
+    }
+}
+
+} // anonymous namespace
+
+CompactExecutable::CompactExecutable(Executable const & executable)
+    : m_fileFormatVersion(executable.fileFormatVersion)
+    , m_activeLinkingUnitIndex(executable.activeLinkingUnitIndex)
+    , m_linkingUnits(executable.linkingUnits.size())
+{
+    /* Determine the layout of the storage of all sections: */
+    std::size_t storageSize = 0u;
+    for (auto const & lu : executable.linkingUnits) {
+        forEachSection(
+                lu,
+                [&storageSize](SectionType, std::size_t size) {
+                    if (size > std::numeric_limits<std::size_t>::max()
+                               - storageSize - storageAlignment)
+                        throw std::bad_alloc();
+                    storageSize += (size + (storageAlignment - 1u))
+                                   & ~(storageAlignment - 1u);
+                });
+    }
+
+    auto const storage =
+            static_cast<char *>(allocateLargePageStorage(storageSize));
+    m_storage = storage;
+    m_storageSize = storageSize;
+
+    /* Copy the contents of all sections to the storage: */
+    std::size_t offset = 0u;
+    for (std::size_t luIndex = 0u; luIndex < m_linkingUnits.size(); ++luIndex)
+    {
+        auto const & lu = executable.linkingUnits[luIndex];
+        auto & compactLu = m_linkingUnits[luIndex];
+        forEachSection(
+                lu,
+                [&lu, &compactLu, storage, &offset](SectionType type,
+                                                    std::size_t size) noexcept
+                {
+                    auto const dest = storage + offset;
+                    auto & descriptor =
+                            compactLu.m_sections[
+                                static_cast<std::size_t>(type)];
+                    switch (type) {
+                    case SectionType::Text:
+                        if (size)
+                            std::memcpy(dest,
+                                        lu.textSection->instructions.data(),
+                                        size);
+                        descriptor = {dest,
+                                      lu.textSection->instructions.size()};
+                        break;
+                    case SectionType::RoData:
+                    case SectionType::Data:
+                    case SectionType::Debug:
+                        {
+                            auto const & section =
+                                    (type == SectionType::RoData)
+                                    ? *lu.roDataSection
+                                    : (type == SectionType::Data)
+                                      ? *lu.rwDataSection
+                                      : *lu.debugSection;
+                            if (size)
+                                std::memcpy(dest, section.data.get(), size);
+                            descriptor = {dest, size};
+                        }
+                        break;
+                    case SectionType::Bss:
+                        descriptor = {nullptr, lu.bssSection->sizeInBytes};
+                        break;
+                    case SectionType::Bind:
+                        copyBindings(lu.syscallBindingsSection->syscallBindings,
+                                     dest);
+                        descriptor = {
+                            dest,
+                            lu.syscallBindingsSection->syscallBindings.size()};
+                        break;
+                    default:
+                        assert(type == SectionType::PdBind);
+                        copyBindings(lu.pdBindingsSection->pdBindings, dest);
+                        descriptor = {dest,
+                                      lu.pdBindingsSection->pdBindings.size()};
+                        break;
+                    }
+                    compactLu.m_sectionTypes[compactLu.m_numSections++] = type;
+                    compactLu.m_sectionMask |=
+                            1u << static_cast<unsigned>(type);
+                    offset += (size + (storageAlignment - 1u))
+                              & ~(storageAlignment - 1u);
+                });
+    }
+    assert(offset == storageSize);
+}
+
+CompactExecutable::CompactExecutable(CompactExecutable && move) noexcept
+    : m_fileFormatVersion(move.m_fileFormatVersion)
+    , m_activeLinkingUnitIndex(move.m_activeLinkingUnitIndex)
+    , m_linkingUnits(std::move(move.m_linkingUnits))
+    , m_storage(std::exchange(move.m_storage, nullptr))
+    , m_storageSize(std::exchange(move.m_storageSize, 0u))
+{}
+
+CompactExecutable & CompactExecutable::operator=(CompactExecutable && move)
+        noexcept
+{
+    if (this != &move) {
+        if (m_storage)
+            deallocateLargePageStorage(m_storage, m_storageSize);
+        m_fileFormatVersion = move.m_fileFormatVersion;
+        m_activeLinkingUnitIndex = move.m_activeLinkingUnitIndex;
+        m_linkingUnits = std::move(move.m_linkingUnits);
+        m_storage = std::exchange(move.m_storage, nullptr);
+        m_storageSize = std::exchange(move.m_storageSize, 0u);
+    }
+    return *this;
+}
+
+CompactExecutable::~CompactExecutable() noexcept {
+    if (m_storage)
+        deallocateLargePageStorage(m_storage, m_storageSize);
+}
+
+} // namespace sharemind {
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#ifndef SHAREMIND_LIBEXECUTABLE_COMPACTEXECUTABLE_H
+#define SHAREMIND_LIBEXECUTABLE_COMPACTEXECUTABLE_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <sharemind/codeblock.h>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Executable.h"
+
+
+namespace sharemind {
+
+/*
+  An immutable copy of an executable in a compact layout. The contents of all
+  sections of all linking units are placed in a single allocation, and each
+  linking unit describes its sections in a fixed array indexed by section
+  type instead of through separately allocated section objects.
+*/
+class CompactExecutable {
+
+public: /* Types: */
+
+    using SectionType = ExecutableSectionHeader0x0::SectionType;
+
+    static constexpr std::size_t const numSectionTypes =
+            static_cast<std::size_t>(SectionType::Count);
+
+    /*
+      Typed views of the sections of a linking unit, as passed to the
+      visitor of LinkingUnit::forEachSection(). Each view has a static
+      member type denoting its section type.
+    */
+    template <SectionType Type> struct SectionView;
+
+    template <SectionType Type>
+    struct DataSectionView {
+        static constexpr SectionType const type = Type;
+        void const * data;
+        std::size_t sizeInBytes;
+    };
+
+    template <SectionType Type>
+    struct BindingsSectionView {
+        static constexpr SectionType const type = Type;
+        std::string_view const * begin() const noexcept { return bindings; }
+        std::string_view const * end() const noexcept
+        { return bindings + size; }
+        std::string_view operator[](std::size_t index) const noexcept
+        { return bindings[index]; }
+        std::string_view const * bindings;
+        std::size_t size;
+    };
+
+    class LinkingUnit {
+
+        friend class CompactExecutable;
+
+    public: /* Methods: */
+
+        bool hasSection(SectionType type) const noexcept
+        { return m_sectionMask & (1u << static_cast<unsigned>(type)); }
+
+        std::size_t numberOfSections() const noexcept
+        { return m_numSections; }
+
+        /*
+          Calls the given visitor with the view of each section of the
+          linking unit in the order of their section types.
+        */
+        template <typename Visitor>
+        void forEachSection(Visitor && visitor) const {
+            for (std::size_t i = 0u; i < m_numSections; ++i)
+                visitSection(m_sectionTypes[i], visitor);
+        }
+
+        /* Calls the given visitor with the view of the given section: */
+        template <typename Visitor>
+        void visitSection(SectionType type, Visitor && visitor) const {
+            assert(hasSection(type));
+            switch (type) {
+            case SectionType::Text:
+                visitor(view<SectionType::Text>());
+                break;
+            case SectionType::RoData:
+                visitor(view<SectionType::RoData>());
+                break;
+            case SectionType::Data:
+                visitor(view<SectionType::Data>());
+                break;
+            case SectionType::Bss:
+                visitor(view<SectionType::Bss>());
+                break;
+            case SectionType::Bind:
+                visitor(view<SectionType::Bind>());
+                break;
+            case SectionType::PdBind:
+                visitor(view<SectionType::PdBind>());
+                break;
+            default:
+                assert(type == SectionType::Debug);
+                visitor(view<SectionType::Debug>());
+                break;
+            }
+        }
+
+        /* The view of the given section, which must be present: */
+        template <SectionType Type>
+        SectionView<Type> view() const noexcept {
+            assert(hasSection(Type));
+            auto const & descriptor =
+                    m_sections[static_cast<std::size_t>(Type)];
+            if constexpr (Type == SectionType::Text) {
+                return SectionView<Type>{
+                            static_cast<SharemindCodeBlock const *>(
+                                descriptor.data),
+                            descriptor.size};
+            } else if constexpr (Type == SectionType::Bss) {
+                return SectionView<Type>{descriptor.size};
+            } else if constexpr ((Type == SectionType::Bind)
+                                 || (Type == SectionType::PdBind))
+            {
+                return SectionView<Type>{
+                            static_cast<std::string_view const *>(
+                                descriptor.data),
+                            descriptor.size};
+            } else {
+                return SectionView<Type>{descriptor.data, descriptor.size};
+            }
+        }
+
+    private: /* Types: */
+
+        struct SectionDescriptor {
+            void const * data;
+            std::size_t size;
+        };
+
+    private: /* Fields: */
+
+        std::array<SectionDescriptor, numSectionTypes> m_sections{};
+        std::array<SectionType, numSectionTypes> m_sectionTypes{};
+        std::uint8_t m_numSections = 0u;
+        std::uint8_t m_sectionMask = 0u;
+
+    };
+
+public: /* Methods: */
+
+    explicit CompactExecutable(Executable const & executable);
+
+    CompactExecutable(CompactExecutable &&) noexcept;
+    CompactExecutable(CompactExecutable const &) = delete;
+
+    CompactExecutable & operator=(CompactExecutable &&) noexcept;
+    CompactExecutable & operator=(CompactExecutable const &) = delete;
+
+    ~CompactExecutable() noexcept;
+
+    std::size_t fileFormatVersion() const noexcept
+    { return m_fileFormatVersion; }
+
+    std::size_t activeLinkingUnitIndex() const noexcept
+    { return m_activeLinkingUnitIndex; }
+
+    std::size_t numberOfLinkingUnits() const noexcept
+    { return m_linkingUnits.size(); }
+
+    LinkingUnit const & linkingUnit(std::size_t index) const noexcept
+    { return m_linkingUnits[index]; }
+
+    LinkingUnit const & activeLinkingUnit() const noexcept
+    { return linkingUnit(m_activeLinkingUnitIndex); }
+
+    /* The size of the allocation holding the contents of all sections: */
+    std::size_t storageSizeInBytes() const noexcept { return m_storageSize; }
+
+private: /* Fields: */
+
+    std::size_t m_fileFormatVersion;
+    std::size_t m_activeLinkingUnitIndex;
+    std::vector<LinkingUnit> m_linkingUnits;
+    void * m_storage = nullptr;
+    std::size_t m_storageSize = 0u;
+
+};
+
+template <>
+struct CompactExecutable::SectionView<CompactExecutable::SectionType::Text> {
+    static constexpr SectionType const type = SectionType::Text;
+    SharemindCodeBlock const * instructions;
+    std::size_t size;
+};
+
+template <>
+struct CompactExecutable::SectionView<CompactExecutable::SectionType::RoData>
+    : DataSectionView<SectionType::RoData>
+{};
+
+template <>
+struct CompactExecutable::SectionView<CompactExecutable::SectionType::Data>
+    : DataSectionView<SectionType::Data>
+{};
+
+template <>
+struct CompactExecutable::SectionView<CompactExecutable::SectionType::Bss> {
+    static constexpr SectionType const type = SectionType::Bss;
+    std::size_t sizeInBytes;
+};
+
+template <>
+struct CompactExecutable::SectionView<CompactExecutable::SectionType::Bind>
+    : BindingsSectionView<SectionType::Bind>
+{};
+
+template <>
+struct CompactExecutable::SectionView<CompactExecutable::SectionType::PdBind>
+    : BindingsSectionView<SectionType::PdBind>
+{};
+
+template <>
+struct CompactExecutable::SectionView<CompactExecutable::SectionType::Debug>
+    : DataSectionView<SectionType::Debug>
+{};
+
+} /* namespace sharemind { */
+
+#endif /* SHAREMIND_LIBEXECUTABLE_COMPACTEXECUTABLE_H */
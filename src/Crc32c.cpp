@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#include "Crc32c.h"
+
+#include <array>
+#include <cstring>
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#endif
+
+
+namespace sharemind {
+namespace {
+
+/*******************************************************************************
+  Portable implementation (slicing-by-8).
+*******************************************************************************/
+
+using Table = std::array<std::array<std::uint32_t, 256u>, 8u>;
+
+constexpr Table generateTable() noexcept {
+    Table table{};
+    for (std::uint32_t i = 0u; i < 256u; ++i) {
+        std::uint32_t crc = i;
+        for (unsigned j = 0u; j < 8u; ++j)
+            crc = (crc >> 1u) ^ ((crc & 1u) ? 0x82f63b78u : 0u);
+        table[0u][i] = crc;
+    }
+    for (std::uint32_t i = 0u; i < 256u; ++i)
+        for (std::size_t t = 1u; t < 8u; ++t)
+            table[t][i] = (table[t - 1u][i] >> 8u)
+                          ^ table[0u][table[t - 1u][i] & 0xffu];
+    return table;
+}
+
+constexpr Table const table(generateTable());
+
+inline std::uint32_t tableUpdateByte(std::uint32_t crc,
+                                     unsigned char const c) noexcept
+{ return (crc >> 8u) ^ table[0u][(crc ^ c) & 0xffu]; }
+
+inline std::uint32_t tableUpdateWord(std::uint32_t crc,
+                                     unsigned char const * p) noexcept
+{
+    /* Processes the bytes in order regardless of the host byte order: */
+    crc ^= static_cast<std::uint32_t>(p[0u])
+           | (static_cast<std::uint32_t>(p[1u]) << 8u)
+           | (static_cast<std::uint32_t>(p[2u]) << 16u)
+           | (static_cast<std::uint32_t>(p[3u]) << 24u);
+    return table[7u][crc & 0xffu]
+           ^ table[6u][(crc >> 8u) & 0xffu]
+           ^ table[5u][(crc >> 16u) & 0xffu]
+           ^ table[4u][crc >> 24u]
+           ^ table[3u][p[4u]]
+           ^ table[2u][p[5u]]
+           ^ table[1u][p[6u]]
+           ^ table[0u][p[7u]];
+}
+
+std::uint32_t tableCrc32c(std::uint32_t crc,
+                          void * dest,
+                          void const * src,
+                          std::size_t size) noexcept
+{
+    auto in = static_cast<unsigned char const *>(src);
+    auto out = static_cast<unsigned char *>(dest);
+    for (; size >= 8u; size -= 8u, in += 8u) {
+        crc = tableUpdateWord(crc, in);
+        if (out) {
+            std::memcpy(out, in, 8u);
+            out += 8u;
+        }
+    }
+    for (; size; --size, ++in) {
+        crc = tableUpdateByte(crc, *in);
+        if (out)
+            *out++ = *in;
+    }
+    return crc;
+}
+
+
+/*******************************************************************************
+  Hardware implementations.
+*******************************************************************************/
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2")))
+std::uint32_t hardwareCrc32c(std::uint32_t crc,
+                             void * dest,
+                             void const * src,
+                             std::size_t size) noexcept
+{
+    auto in = static_cast<unsigned char const *>(src);
+    auto out = static_cast<unsigned char *>(dest);
+    std::uint64_t crc64 = crc;
+    for (; size >= 8u; size -= 8u, in += 8u) {
+        std::uint64_t word;
+        std::memcpy(&word, in, 8u);
+        crc64 = _mm_crc32_u64(crc64, word);
+        if (out) {
+            std::memcpy(out, &word, 8u);
+            out += 8u;
+        }
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+    for (; size; --size, ++in) {
+        crc = _mm_crc32_u8(crc, *in);
+        if (out)
+            *out++ = *in;
+    }
+    return crc;
+}
+
+bool hardwareCrc32cSupported() noexcept {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+}
+
+#elif defined(__aarch64__)
+
+__attribute__((target("+crc")))
+std::uint32_t hardwareCrc32c(std::uint32_t crc,
+                             void * dest,
+                             void const * src,
+                             std::size_t size) noexcept
+{
+    auto in = static_cast<unsigned char const *>(src);
+    auto out = static_cast<unsigned char *>(dest);
+    for (; size >= 8u; size -= 8u, in += 8u) {
+        std::uint64_t word;
+        std::memcpy(&word, in, 8u);
+        crc = __crc32cd(crc, word);
+        if (out) {
+            std::memcpy(out, &word, 8u);
+            out += 8u;
+        }
+    }
+    for (; size; --size, ++in) {
+        crc = __crc32cb(crc, *in);
+        if (out)
+            *out++ = *in;
+    }
+    return crc;
+}
+
+bool hardwareCrc32cSupported() noexcept
+{ return ::getauxval(AT_HWCAP) & HWCAP_CRC32; }
+
+#endif
+
+using Implementation = std::uint32_t (*)(std::uint32_t,
+                                         void *,
+                                         void const *,
+                                         std::size_t) noexcept;
+
+Implementation selectImplementation() noexcept {
+    #if defined(__x86_64__) || defined(__aarch64__)
+    if (hardwareCrc32cSupported())
+        return &hardwareCrc32c;
+    #endif
+    return &tableCrc32c;
+}
+
+Implementation implementation() noexcept {
+    static Implementation const r = selectImplementation();
+    return r;
+}
+
+} // anonymous namespace
+
+std::uint32_t crc32c(std::uint32_t crc, void const * data, std::size_t size)
+        noexcept
+{ return ~implementation()(~crc, nullptr, data, size); }
+
+std::uint32_t crc32cCopy(std::uint32_t crc,
+                         void * dest,
+                         void const * src,
+                         std::size_t size) noexcept
+{ return ~implementation()(~crc, dest, src, size); }
+
+} // namespace sharemind {
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#ifndef SHAREMIND_LIBEXECUTABLE_CRC32C_H
+#define SHAREMIND_LIBEXECUTABLE_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace sharemind {
+
+/*
+  CRC-32C (Castagnoli) checksums as used in Sharemind Executable file format
+  version 0x1. These use the SSE 4.2 or ARMv8 CRC32 instructions if supported
+  by the CPU, and a table-driven implementation otherwise. Checksums can be
+  computed incrementally by passing the result for the preceding data as the
+  crc argument, starting from zero.
+*/
+
+std::uint32_t crc32c(std::uint32_t crc, void const * data, std::size_t size)
+        noexcept;
+
+/* Copies size bytes from src to dest and returns the checksum of these: */
+std::uint32_t crc32cCopy(std::uint32_t crc,
+                         void * dest,
+                         void const * src,
+                         std::size_t size) noexcept;
+
+} /* namespace sharemind { */
+
+#endif /* SHAREMIND_LIBEXECUTABLE_CRC32C_H */
@@ -19,145 +19,133 @@
 
 #include "Executable.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <functional>
+#include <future>
 #include <istream>
+#include <iterator>
 #include <limits>
+#include <memory_resource>
+#include <mutex>
 #include <new>
 #include <ostream>
 #include <sharemind/Concat.h>
-#include <sharemind/DebugOnly.h>
-#include <sharemind/GlobalDeleter.h>
 #include <sharemind/IntegralComparisons.h>
 #include <sharemind/ThrowNested.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <system_error>
 #include <type_traits>
-#include <unordered_set>
+#include <unistd.h>
 #include <utility>
+#include <zstd.h>
+#include "Crc32c.h"
 #include "libexecutable.h"
 #include "libexecutable_0x0.h"
+#include "libexecutable_0x1.h"
 
 
 namespace sharemind {
 namespace {
 
-template <
-        typename T,
-        bool checkIsNeeded = (std::numeric_limits<T>::max()
-                              >= std::numeric_limits<std::size_t>::max())
->
-struct ValidNumberOfInstructionsCheck {
-    static void check(T) noexcept {}
-};
-
-template <typename T>
-struct ValidNumberOfInstructionsCheck<T, true> {
-    static void check(T t) noexcept {
-        if (t >= std::numeric_limits<std::size_t>::max())
-            throw std::bad_array_new_length();
-    }
-};
-
-template <typename T>
-inline void checkValidNumberOfInstructions(T t)
-{ return ValidNumberOfInstructionsCheck<T>::check(t); }
-
-template <typename Exception>
-struct ThrowingBindingsSizeOverflowCheck {
+/*
+  Returns the memory resource to be used for the contents of sections by the
+  given allocator, or nullptr if large page backed storage is to be used:
+*/
+std::pmr::memory_resource * contentsResource(
+        Executable::allocator_type const & allocator) noexcept
+{
+    auto const resource = allocator.resource();
+    return (resource == std::pmr::new_delete_resource()) ? nullptr : resource;
+}
 
-    template <typename BindingSize, typename SizeLeft>
-    void operator()(BindingSize bindingSize, SizeLeft sizeLeft) {
-        if (bindingSize > sizeLeft)
-            throw Exception();
-    }
+/* Returns section data to the memory resource it was allocated from: */
+struct ResourcePayloadDeleter {
+    void operator()(void * ptr) const noexcept
+    { resource->deallocate(ptr, size); }
 
+    std::pmr::memory_resource * resource;
+    std::size_t size;
 };
 
-struct AssertingBindingsSizeOverflowCheck {
+/*
+  Allocates uninitialized storage for section data from the given allocator,
+  backed by large pages if the size warrants it and large pages are enabled:
+*/
+std::shared_ptr<void> allocatePayload(
+        std::size_t size,
+        Executable::allocator_type const & allocator)
+{
+    if (auto const resource = contentsResource(allocator))
+        return std::shared_ptr<void>(resource->allocate(size),
+                                     ResourcePayloadDeleter{resource, size},
+                                     allocator);
+    return std::shared_ptr<void>(
+                allocateLargePageStorage(size),
+                [size](void * ptr) noexcept
+                { deallocateLargePageStorage(ptr, size); });
+}
 
-    template <typename BindingSize, typename SizeLeft>
-    void operator()(BindingSize SHAREMIND_DEBUG_ONLY(bindingSize),
-                    SizeLeft SHAREMIND_DEBUG_ONLY(sizeLeft))
-    { assert(bindingSize <= sizeLeft); }
+/* Returns the allocator the given section data was allocated with: */
+Executable::allocator_type payloadAllocator(
+        std::shared_ptr<void> const & payload) noexcept
+{
+    if (auto const deleter = std::get_deleter<ResourcePayloadDeleter>(payload))
+        return deleter->resource;
+    return Executable::allocator_type();
+}
 
-};
+template <typename Section, typename ... Args>
+std::shared_ptr<Section> allocateSection(
+        Executable::allocator_type const & allocator,
+        Args && ... args)
+{
+    return std::allocate_shared<Section>(
+                std::pmr::polymorphic_allocator<Section>(allocator),
+                std::forward<Args>(args)...);
+}
 
-template <typename BindingsSizeOverflowCheck,
-          typename BindingsContainer>
-std::size_t calculateBindingsSize(BindingsContainer const & bindings) {
-    std::size_t r = bindings.size();
-    std::size_t sizeLeft = std::numeric_limits<std::size_t>::max() - r;
-    for (auto const & binding : bindings) {
-        auto const bindingSize = binding.size();
-        BindingsSizeOverflowCheck()(bindingSize, sizeLeft);
-        r += binding.size();
-        sizeLeft -= binding.size();
+/* Copies the given section, if any, using the given allocator: */
+template <typename Section>
+std::shared_ptr<Section> copySection(
+        std::shared_ptr<Section> const & section,
+        Executable::allocator_type const & allocator)
+{
+    if (!section)
+        return nullptr;
+    if constexpr (std::is_constructible<
+                        Section,
+                        Section const &,
+                        Executable::allocator_type const &>::value)
+    {
+        return allocateSection<Section>(allocator, *section, allocator);
+    } else {
+        return allocateSection<Section>(allocator, *section);
     }
-    return r;
 }
 
+/* Checks that the size fits the section header of the given format version: */
 template <typename Exception>
-void checkSectionSize(std::size_t size) {
-    using SS = ExecutableSectionHeader0x0::SizeType;
-    if (size > std::numeric_limits<SS>::max())
+void checkSectionSize(std::size_t size, std::size_t version) {
+    using SS0x0 = ExecutableSectionHeader0x0::SizeType;
+    using SS0x1 = ExecutableSectionHeader0x1::SizeType;
+    if ((version == 0x0u)
+        ? integralGreater(size, std::numeric_limits<SS0x0>::max())
+        : integralGreater(size, std::numeric_limits<SS0x1>::max()))
         throw Exception();
 };
 
-std::ostream & serializeSectionHeader(
-        std::ostream & os,
-        ExecutableSectionHeader0x0::SectionType type,
-        std::size_t size) noexcept
-{
-    using SS = ExecutableSectionHeader0x0::SizeType;
-    assert(size <= std::numeric_limits<SS>::max());
-
-    ExecutableSectionHeader0x0 sectionHeader0x0;
-    sectionHeader0x0.init(type, static_cast<SS>(size));
-    assert(sectionHeader0x0.isValid());
-    return os << sectionHeader0x0;
-};
-
 constexpr std::streamsize const extraPaddingSize[8u] =
         { 0u, 7u, 6u, 5u, 4u, 3u, 2u, 1u };
 char const extraPadding[8u] = "\0\0\0\0\0\0\0";
 
-std::ostream & serializeRegularSection(
-        std::ostream & os,
-        ExecutableSectionHeader0x0::SectionType type,
-        void const * data,
-        std::size_t size)
-{
-    if (!serializeSectionHeader(os, type, size))
-        return os;
-
-    static constexpr auto const writePatch =
-            std::numeric_limits<std::streamsize>::max();
-    auto d = static_cast<char const *>(data);
-    while (size > writePatch) {
-        if (!os.write(d, writePatch))
-            return os;
-        size -= writePatch;
-        d += writePatch;
-    }
-    if (!os.write(d, static_cast<std::streamsize>(size)))
-        return os;
-    return os.write(extraPadding, extraPaddingSize[size % 8u]);
-}
-
-std::ostream & serializeBindingsSection(
-        std::ostream & os,
-        ExecutableSectionHeader0x0::SectionType type,
-        std::vector<std::string> const & bindings)
-{
-    auto const size =
-            calculateBindingsSize<AssertingBindingsSizeOverflowCheck>(bindings);
-    if (!serializeSectionHeader(os, type, size))
-        return os;
-    for (auto const & binding : bindings)
-        if (!os.write(binding.c_str(),
-                      static_cast<std::streamsize>(binding.size() + 1u)))
-            return os;
-    return os.write(extraPadding, extraPaddingSize[size % 8u]);
-}
-
 template <typename ... ExceptionGenerators>
 std::istream & istreamSetFailure(std::istream & is,
                                  ExceptionGenerators ... exceptionGenerators)
@@ -170,6 +158,21 @@ std::istream & istreamSetFailure(std::istream & is,
     return is;
 }
 
+inline std::istream & istreamSetFailure(std::istream & is,
+                                        std::exception_ptr exception)
+{
+    try {
+        is.setstate(std::ios_base::failbit);
+    } catch (std::ios_base::failure const & e) {
+        try {
+            std::rethrow_exception(std::move(exception));
+        } catch (...) {
+            std::throw_with_nested(e);
+        }
+    }
+    return is;
+}
+
 template <typename ValueToRead, typename ... ExceptionGenerators>
 std::istream & istreamReadValue(std::istream & is,
                                 ValueToRead & value,
@@ -186,66 +189,6 @@ template <typename ReadFailedException, typename ValueToRead>
 std::istream & istreamReadValue(std::istream & is, ValueToRead & value)
 { return istreamReadValue(is, value, []() { return ReadFailedException(); }); }
 
-template <typename SizeType, typename ... ExceptionGenerators>
-std::istream & istreamReadRawData(std::istream & is,
-                                  void * buffer,
-                                  SizeType size,
-                                  ExceptionGenerators ... exceptionGenerators)
-{
-    static constexpr auto const maxRead =
-            std::numeric_limits<std::streamsize>::max();
-    auto buf = static_cast<char *>(buffer);
-    try {
-        while (integralGreater(size, maxRead)) {
-            if (!is.read(buf, maxRead))
-                return is;
-            size -= maxRead;
-            buf += maxRead;
-        }
-        if (!is.read(buf, static_cast<std::streamsize>(size)))
-            return is;
-    } catch (std::ios_base::failure const & e) {
-        throwNested(exceptionGenerators()..., e);
-    }
-    return is;
-}
-
-class LimitedBufferFilter: public std::streambuf {
-
-public: /* Methods: */
-
-    LimitedBufferFilter(LimitedBufferFilter &&) = delete;
-    LimitedBufferFilter(LimitedBufferFilter const &) = delete;
-
-    LimitedBufferFilter(std::istream & srcStream, std::size_t size)
-        : m_srcStream(srcStream)
-        , m_sizeLeft(size)
-    {}
-
-protected: /* Methods: */
-
-    int_type underflow() override {
-        if (gptr() < egptr())
-            return traits_type::to_int_type(m_buf);
-        if (m_sizeLeft <= 0u)
-            return traits_type::eof();
-        auto r(m_srcStream.get());
-        if (r == traits_type::eof())
-            return r;
-        --m_sizeLeft;
-        m_buf = traits_type::to_char_type(std::move(r));
-        this->setg(&m_buf, &m_buf, &m_buf + 1u);
-        return r;
-    }
-
-private: /* Fields: */
-
-    std::istream & m_srcStream;
-    std::size_t m_sizeLeft;
-    char m_buf;
-
-};
-
 } // anonymous namespace
 
 SHAREMIND_DEFINE_EXCEPTION_NOINLINE(sharemind::Exception,
@@ -318,6 +261,24 @@ SHAREMIND_DEFINE_EXCEPTION_CONST_MSG_NOINLINE(
         Executable::,
         DebugSectionTooBigException,
         "Debug section is too big to serialize!");
+SHAREMIND_DEFINE_EXCEPTION_CONST_MSG_NOINLINE(
+        NotSerializableException,
+        Executable::,
+        InvalidCompressionBlockSizeException,
+        "Invalid compression block size!");
+SHAREMIND_DEFINE_EXCEPTION_CONST_MSG_NOINLINE(
+        NotSerializableException,
+        Executable::,
+        InvalidPayloadAlignmentException,
+        "Invalid section payload alignment!");
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        NotSerializableException,
+        Executable::,
+        FailedToCompressSectionException);
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        Exception,
+        Executable::,
+        FailedToWriteException);
 SHAREMIND_DEFINE_EXCEPTION_NOINLINE(Exception,
                                     Executable::,
                                     DeserializationException);
@@ -332,6 +293,12 @@ SHAREMIND_DEFINE_EXCEPTION_CONST_MSG_NOINLINE(
         FailedToDeserializeFileHeader0x0Exception,
         "Failed to deserialize Sharemind executable file header specific to "
         "format version 0!");
+SHAREMIND_DEFINE_EXCEPTION_CONST_MSG_NOINLINE(
+        DeserializationException,
+        Executable::,
+        FailedToDeserializeFileHeader0x1Exception,
+        "Failed to deserialize Sharemind executable file header specific to "
+        "format version 1!");
 SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
         DeserializationException,
         Executable::,
@@ -340,6 +307,10 @@ SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
         DeserializationException,
         Executable::,
         FailedToDeserializeSectionHeader0x0Exception);
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        DeserializationException,
+        Executable::,
+        FailedToDeserializeSectionHeader0x1Exception);
 SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
         DeserializationException,
         Executable::,
@@ -400,6 +371,18 @@ SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
         DeserializationException,
         Executable::,
         InvalidZeroPaddingException);
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        DeserializationException,
+        Executable::,
+        FailedToDecompressSectionException);
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        DeserializationException,
+        Executable::,
+        SectionTooBigException);
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        DeserializationException,
+        Executable::,
+        ChecksumMismatchException);
 SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
         DeserializationException,
         Executable::,
@@ -416,6 +399,18 @@ SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
         DeserializationException,
         Executable::,
         EmptyPdBindingException);
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        DeserializationException,
+        Executable::,
+        FailedToOpenFileException);
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        DeserializationException,
+        Executable::,
+        FailedToMapFileException);
+SHAREMIND_DEFINE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+        DeserializationException,
+        Executable::,
+        FailedToReadFileException);
 
 
 Executable::DataSection::DataSection() noexcept {}
@@ -429,7 +424,14 @@ Executable::DataSection::DataSection(std::shared_ptr<void> dataPtr,
 Executable::DataSection::DataSection(void const * dataPtr,
                                      std::size_t dataSizeInBytes,
                                      CopyDataTag const)
-    : data(::operator new(dataSizeInBytes), GlobalDeleter())
+    : DataSection(dataPtr, dataSizeInBytes, CopyData, allocator_type())
+{}
+
+Executable::DataSection::DataSection(void const * dataPtr,
+                                     std::size_t dataSizeInBytes,
+                                     CopyDataTag const,
+                                     allocator_type const & allocator)
+    : data(allocatePayload(dataSizeInBytes, allocator))
     , sizeInBytes(dataSizeInBytes)
 { std::memcpy(data.get(), dataPtr, dataSizeInBytes); }
 
@@ -439,15 +441,25 @@ Executable::DataSection::DataSection(DataSection const & copy)
     : DataSection(copy.data.get(), copy.sizeInBytes, CopyData)
 {}
 
+Executable::DataSection::DataSection(DataSection const & copy,
+                                     allocator_type const & allocator)
+    : DataSection(copy.data.get(), copy.sizeInBytes, CopyData, allocator)
+{}
+
 Executable::DataSection & Executable::DataSection::operator=(DataSection &&)
         noexcept = default;
 
 Executable::DataSection & Executable::DataSection::operator=(
         DataSection const & copy)
 {
-    data = std::shared_ptr<void>(::operator new(copy.sizeInBytes),
-                                 GlobalDeleter());
-    sizeInBytes = copy.sizeInBytes;
+    if (this != &copy) {
+        /* Keep using the memory resource of this section, if any: */
+        auto newData(allocatePayload(copy.sizeInBytes,
+                                     payloadAllocator(data)));
+        std::memcpy(newData.get(), copy.data.get(), copy.sizeInBytes);
+        data = std::move(newData);
+        sizeInBytes = copy.sizeInBytes;
+    }
     return *this;
 }
 
@@ -457,17 +469,33 @@ Executable::TextSection::TextSection()
         noexcept(std::is_nothrow_default_constructible<Container>::value)
         = default;
 
+Executable::TextSection::TextSection(allocator_type const & allocator)
+        noexcept
+    : instructions(Container::allocator_type(contentsResource(allocator)))
+{}
+
 Executable::TextSection::TextSection(TextSection &&)
         noexcept(std::is_nothrow_move_constructible<Container>::value)
         = default;
 
 Executable::TextSection::TextSection(TextSection const &) = default;
 
+Executable::TextSection::TextSection(TextSection const & copy,
+                                     allocator_type const & allocator)
+    : instructions(copy.instructions,
+                   Container::allocator_type(contentsResource(allocator)))
+{}
+
 Executable::TextSection::TextSection(Container instructions_)
         noexcept(std::is_nothrow_move_constructible<Container>::value)
     : instructions(std::move(instructions_))
 {}
 
+Executable::TextSection::TextSection(
+        std::vector<SharemindCodeBlock> const & instructions_)
+    : instructions(instructions_.begin(), instructions_.end())
+{}
+
 Executable::TextSection & Executable::TextSection::operator=(TextSection &&)
         noexcept(std::is_nothrow_move_assignable<Container>::value) = default;
 
@@ -476,10 +504,155 @@ Executable::TextSection & Executable::TextSection::operator=(
 
 
 
+Executable::BindingsTable::BindingsTable() noexcept = default;
+
+Executable::BindingsTable::BindingsTable(allocator_type const & allocator)
+        noexcept
+    : m_data(allocator)
+    , m_offsets(allocator)
+    , m_hashes(allocator)
+    , m_slots(allocator)
+{}
+
+Executable::BindingsTable::BindingsTable(BindingsTable &&) noexcept = default;
+
+Executable::BindingsTable::BindingsTable(BindingsTable const &) = default;
+
+Executable::BindingsTable::BindingsTable(BindingsTable const & copy,
+                                         allocator_type const & allocator)
+    : m_data(copy.m_data, allocator)
+    , m_offsets(copy.m_offsets, allocator)
+    , m_hashes(copy.m_hashes, allocator)
+    , m_slots(copy.m_slots, allocator)
+    , m_numIndexed(copy.m_numIndexed)
+{}
+
+Executable::BindingsTable::BindingsTable(
+        std::initializer_list<std::string_view> bindings)
+    : BindingsTable(bindings.begin(), bindings.end())
+{}
+
+Executable::BindingsTable & Executable::BindingsTable::operator=(
+        BindingsTable &&) = default;
+
+Executable::BindingsTable & Executable::BindingsTable::operator=(
+        BindingsTable const &) = default;
+
+void Executable::BindingsTable::reserve(size_type numBindings,
+                                        size_type sizeInBytes)
+{
+    m_data.reserve(sizeInBytes);
+    m_offsets.reserve(numBindings);
+    m_hashes.reserve(numBindings);
+    if (numBindings > m_slots.size() / 2u) {
+        size_type numSlots = 16u;
+        while (numSlots / 2u < numBindings)
+            numSlots *= 2u;
+        rehash(numSlots);
+    }
+}
+
+void Executable::BindingsTable::push_back(std::string_view binding)
+{ append(binding, true); }
+
+bool Executable::BindingsTable::insert(std::string_view binding)
+{ return append(binding, false); }
+
+void Executable::BindingsTable::clear() noexcept {
+    m_data.clear();
+    m_offsets.clear();
+    m_hashes.clear();
+    m_slots.clear();
+    m_numIndexed = 0u;
+}
+
+Executable::BindingsTable::size_type Executable::BindingsTable::find(
+        std::string_view binding) const noexcept
+{
+    if (!m_numIndexed)
+        return npos;
+    auto const slot =
+            findSlot(binding, std::hash<std::string_view>()(binding));
+    return m_slots[slot] ? m_slots[slot] - 1u : npos;
+}
+
+bool Executable::BindingsTable::append(std::string_view binding,
+                                       bool appendDuplicate)
+{
+    assert(binding.find('\0') == std::string_view::npos);
+    auto const hash = std::hash<std::string_view>()(binding);
+    if (m_numIndexed + 1u > m_slots.size() / 2u)
+        rehash(m_slots.empty() ? 16u : m_slots.size() * 2u);
+    auto const slot = findSlot(binding, hash);
+    bool const isDuplicate = (m_slots[slot] != 0u);
+    if (isDuplicate && !appendDuplicate)
+        return false;
+
+    m_offsets.emplace_back(m_data.size());
+    try {
+        m_hashes.emplace_back(hash);
+        try {
+            m_data.append(binding.data(), binding.size()).push_back('\0');
+        } catch (...) {
+            m_data.resize(m_offsets.back());
+            m_hashes.pop_back();
+            throw;
+        }
+    } catch (...) {
+        m_offsets.pop_back();
+        throw;
+    }
+
+    if (!isDuplicate) {
+        m_slots[slot] = m_offsets.size();
+        ++m_numIndexed;
+    }
+    return !isDuplicate;
+}
+
+Executable::BindingsTable::size_type Executable::BindingsTable::findSlot(
+        std::string_view binding,
+        std::size_t hash) const noexcept
+{
+    assert(!m_slots.empty());
+    auto const mask = m_slots.size() - 1u;
+    for (auto slot = hash & mask;; slot = (slot + 1u) & mask) {
+        auto const entry = m_slots[slot];
+        if (!entry
+            || (m_hashes[entry - 1u] == hash
+                && (*this)[entry - 1u] == binding))
+            return slot;
+    }
+}
+
+void Executable::BindingsTable::rehash(size_type numSlots) {
+    assert(numSlots > 0u);
+    assert((numSlots & (numSlots - 1u)) == 0u);
+    assert(numSlots / 2u >= m_numIndexed);
+    std::pmr::vector<size_type> slots(numSlots, 0u, m_slots.get_allocator());
+    auto const mask = numSlots - 1u;
+    for (auto const entry : m_slots) {
+        if (!entry)
+            continue;
+        auto slot = m_hashes[entry - 1u] & mask;
+        while (slots[slot])
+            slot = (slot + 1u) & mask;
+        slots[slot] = entry;
+    }
+    m_slots = std::move(slots);
+}
+
+
+
 Executable::SyscallBindingsSection::SyscallBindingsSection()
         noexcept(std::is_nothrow_default_constructible<Container>::value)
         = default;
 
+Executable::SyscallBindingsSection::SyscallBindingsSection(
+        allocator_type const & allocator) noexcept
+    : syscallBindings(allocator)
+{}
+
 Executable::SyscallBindingsSection::SyscallBindingsSection(
         SyscallBindingsSection &&)
         noexcept(std::is_nothrow_move_constructible<Container>::value)
@@ -488,6 +661,12 @@ Executable::SyscallBindingsSection::SyscallBindingsSection(
 Executable::SyscallBindingsSection::SyscallBindingsSection(
         SyscallBindingsSection const &) = default;
 
+Executable::SyscallBindingsSection::SyscallBindingsSection(
+        SyscallBindingsSection const & copy,
+        allocator_type const & allocator)
+    : syscallBindings(copy.syscallBindings, allocator)
+{}
+
 Executable::SyscallBindingsSection::SyscallBindingsSection(Container bindings)
         noexcept(std::is_nothrow_move_constructible<Container>::value)
     : syscallBindings(std::move(bindings))
@@ -507,6 +686,11 @@ Executable::PdBindingsSection::PdBindingsSection()
         noexcept(std::is_nothrow_default_constructible<Container>::value)
         = default;
 
+Executable::PdBindingsSection::PdBindingsSection(
+        allocator_type const & allocator) noexcept
+    : pdBindings(allocator)
+{}
+
 Executable::PdBindingsSection::PdBindingsSection(PdBindingsSection &&)
         noexcept(std::is_nothrow_move_constructible<Container>::value)
         = default;
@@ -514,6 +698,12 @@ Executable::PdBindingsSection::PdBindingsSection(PdBindingsSection &&)
 Executable::PdBindingsSection::PdBindingsSection(PdBindingsSection const &)
         = default;
 
+Executable::PdBindingsSection::PdBindingsSection(
+        PdBindingsSection const & copy,
+        allocator_type const & allocator)
+    : pdBindings(copy.pdBindings, allocator)
+{}
+
 Executable::PdBindingsSection::PdBindingsSection(Container pdBindings_)
         noexcept(std::is_nothrow_move_constructible<Container>::value)
     : pdBindings(std::move(pdBindings_))
@@ -533,29 +723,30 @@ Executable::LinkingUnit::LinkingUnit() noexcept = default;
 Executable::LinkingUnit::LinkingUnit(LinkingUnit &&) noexcept = default;
 
 Executable::LinkingUnit::LinkingUnit(LinkingUnit const & copy)
-    : textSection(copy.textSection
-                  ? std::make_shared<TextSection>(*copy.textSection)
-                  : std::shared_ptr<TextSection>())
-    , roDataSection(copy.roDataSection
-                    ? std::make_shared<DataSection>(*copy.roDataSection)
-                    : std::shared_ptr<DataSection>())
-    , rwDataSection(copy.rwDataSection
-                    ? std::make_shared<DataSection>(*copy.rwDataSection)
-                    : std::shared_ptr<DataSection>())
-    , bssSection(copy.bssSection
-                 ? std::make_shared<BssSection>(*copy.bssSection)
-                 : std::shared_ptr<BssSection>())
+    : LinkingUnit(copy, allocator_type())
+{}
+
+Executable::LinkingUnit::LinkingUnit(LinkingUnit const & copy,
+                                     ShareSectionsTag const) noexcept
+    : textSection(copy.textSection)
+    , roDataSection(copy.roDataSection)
+    , rwDataSection(copy.rwDataSection)
+    , bssSection(copy.bssSection)
+    , syscallBindingsSection(copy.syscallBindingsSection)
+    , pdBindingsSection(copy.pdBindingsSection)
+    , debugSection(copy.debugSection)
+{}
+
+Executable::LinkingUnit::LinkingUnit(LinkingUnit const & copy,
+                                     allocator_type const & allocator)
+    : textSection(copySection(copy.textSection, allocator))
+    , roDataSection(copySection(copy.roDataSection, allocator))
+    , rwDataSection(copySection(copy.rwDataSection, allocator))
+    , bssSection(copySection(copy.bssSection, allocator))
     , syscallBindingsSection(
-        copy.syscallBindingsSection
-        ? std::make_shared<SyscallBindingsSection>(*copy.syscallBindingsSection)
-        : std::shared_ptr<SyscallBindingsSection>())
-    , pdBindingsSection(
-          copy.pdBindingsSection
-          ? std::make_shared<PdBindingsSection>(*copy.pdBindingsSection)
-          : std::shared_ptr<PdBindingsSection>())
-    , debugSection(copy.debugSection
-                   ? std::make_shared<DataSection>(*copy.debugSection)
-                   : std::shared_ptr<DataSection>())
+          copySection(copy.syscallBindingsSection, allocator))
+    , pdBindingsSection(copySection(copy.pdBindingsSection, allocator))
+    , debugSection(copySection(copy.debugSection, allocator))
 {}
 
 Executable::LinkingUnit & Executable::LinkingUnit::operator=(LinkingUnit &&)
@@ -563,33 +754,7 @@ Executable::LinkingUnit & Executable::LinkingUnit::operator=(LinkingUnit &&)
 
 Executable::LinkingUnit & Executable::LinkingUnit::operator=(
         LinkingUnit const & copy)
-{
-    textSection = copy.textSection
-                  ? std::make_shared<TextSection>(*copy.textSection)
-                  : std::shared_ptr<TextSection>();
-    roDataSection = copy.roDataSection
-                    ? std::make_shared<DataSection>(*copy.roDataSection)
-                    : std::shared_ptr<DataSection>();
-    rwDataSection = copy.rwDataSection
-                    ? std::make_shared<DataSection>(*copy.rwDataSection)
-                    : std::shared_ptr<DataSection>();
-    bssSection = copy.bssSection
-                 ? std::make_shared<BssSection>(*copy.bssSection)
-                 : std::shared_ptr<BssSection>();
-    syscallBindingsSection =
-            copy.syscallBindingsSection
-            ? std::make_shared<SyscallBindingsSection>(
-                  *copy.syscallBindingsSection)
-            : std::shared_ptr<SyscallBindingsSection>();
-    pdBindingsSection =
-          copy.pdBindingsSection
-          ? std::make_shared<PdBindingsSection>(*copy.pdBindingsSection)
-          : std::shared_ptr<PdBindingsSection>();
-    debugSection = copy.debugSection
-                   ? std::make_shared<DataSection>(*copy.debugSection)
-                   : std::shared_ptr<DataSection>();
-    return *this;
-}
+{ return *this = LinkingUnit(copy); }
 
 std::size_t Executable::LinkingUnit::numberOfSections() const noexcept {
     std::size_t r = 0u;
@@ -614,179 +779,2447 @@ std::size_t Executable::LinkingUnit::numberOfSections() const noexcept {
 Executable::Executable()
         noexcept(std::is_nothrow_default_constructible<LuContainer>::value)
         = default;
+Executable::Executable(allocator_type const & allocator) noexcept
+    : linkingUnits(allocator)
+{}
 Executable::Executable(Executable &&)
         noexcept(std::is_nothrow_move_constructible<LuContainer>::value)
         = default;
-Executable::Executable(Executable const &) = default;
+Executable::Executable(Executable const & copy)
+    : Executable(copy, allocator_type())
+{}
+
+Executable::Executable(Executable const & copy, ShareSectionsTag const)
+    : fileFormatVersion(copy.fileFormatVersion)
+    , activeLinkingUnitIndex(copy.activeLinkingUnitIndex)
+{
+    linkingUnits.reserve(copy.linkingUnits.size());
+    for (auto const & lu : copy.linkingUnits)
+        linkingUnits.emplace_back(lu, ShareSections);
+}
+
+Executable::Executable(Executable const & copy,
+                       allocator_type const & allocator)
+    : fileFormatVersion(copy.fileFormatVersion)
+    , linkingUnits(allocator)
+    , activeLinkingUnitIndex(copy.activeLinkingUnitIndex)
+{
+    linkingUnits.reserve(copy.linkingUnits.size());
+    for (auto const & lu : copy.linkingUnits)
+        linkingUnits.emplace_back(lu, allocator);
+}
 
 Executable & Executable::operator=(Executable &&)
         noexcept(std::is_nothrow_move_assignable<LuContainer>::value)
         = default;
-Executable & Executable::operator=(Executable const &) = default;
+Executable & Executable::operator=(Executable const & copy) {
+    if (this != &copy)
+        *this = Executable(copy, get_allocator());
+    return *this;
+}
 
-} // namespace sharemind
+namespace {
 
-std::ostream & operator<<(std::ostream & os, sharemind::Executable const & ex) {
-    using namespace sharemind;
-    using E = Executable;
+class BufferSource {
 
-    if (ex.fileFormatVersion != 0x0)
-        throw Executable::FormatVersionNotSupportedException(
-                concat("Sharemind Executable file format version ",
-                       ex.fileFormatVersion,
-                       " not supported for serialization!"));
+public: /* Methods: */
 
-    if (ex.linkingUnits.empty())
-        throw E::NoLinkingUnitsDefinedException();
-    if (ex.linkingUnits.size() - 1u
-        > std::numeric_limits<ExecutableHeader0x0::NumLinkingUnitsSize>::max())
-        throw E::TooManyLinkingUnitsDefinedException();
-    if (ex.activeLinkingUnitIndex >= ex.linkingUnits.size())
-        throw E::InvalidActiveLinkingUnitException();
+    BufferSource(void const * data, std::size_t size) noexcept
+        : m_data(static_cast<char const *>(data))
+        , m_pos(m_data)
+        , m_sizeLeft(size)
+    {}
 
-    for (auto const & lu : ex.linkingUnits) {
-        auto const numberOfSections = lu.numberOfSections();
-        if (!numberOfSections)
-            throw E::NoSectionsDefinedInLinkingUnitException();
-        using NSS = ExecutableLinkingUnitHeader0x0::NumSectionsSize;
-        if (numberOfSections - 1u > std::numeric_limits<NSS>::max())
-            throw E::TooManySectionsDefinedInLinkingUnitException();
-        if (lu.textSection)
-            checkSectionSize<E::TextSectionTooBigException>(
-                        lu.textSection->instructions.size());
-        if (lu.roDataSection)
-            checkSectionSize<E::RoDataSectionTooBigException>(
-                        lu.roDataSection->sizeInBytes);
-        if (lu.rwDataSection)
-            checkSectionSize<E::RwDataSectionTooBigException>(
-                        lu.rwDataSection->sizeInBytes);
-        if (lu.bssSection)
-            checkSectionSize<E::BssSectionTooBigException>(
-                        lu.bssSection->sizeInBytes);
-        if (lu.syscallBindingsSection)
-            checkSectionSize<E::BindingsSectionTooBigException>(
-                        calculateBindingsSize<
-                            ThrowingBindingsSizeOverflowCheck<
-                                E::BindingsSectionTooBigException> >(
-                            lu.syscallBindingsSection->syscallBindings));
-        if (lu.pdBindingsSection)
-            checkSectionSize<E::BindingsSectionTooBigException>(
-                        calculateBindingsSize<
-                            ThrowingBindingsSizeOverflowCheck<
-                                E::PdBindingsSectionTooBigException> >(
-                            lu.pdBindingsSection->pdBindings));
-        if (lu.debugSection)
-            checkSectionSize<E::DebugSectionTooBigException>(
-                        lu.debugSection->sizeInBytes);
-    }
+    std::size_t offset() const noexcept
+    { return static_cast<std::size_t>(m_pos - m_data); }
 
-    {
-        ExecutableCommonHeader header;
-        header.init(static_cast<ExecutableCommonHeader::FileFormatVersionType>(
-                        0x0));
-        assert(header.isValid());
-        if (!(os << header))
-            return os;
+    char const * read(std::size_t size) noexcept {
+        if (size > m_sizeLeft)
+            return nullptr;
+        auto const r = m_pos;
+        m_pos += size;
+        m_sizeLeft -= size;
+        return r;
     }
 
-    {
-        ExecutableHeader0x0 header0x0;
-        header0x0.init(static_cast<ExecutableHeader0x0::NumLinkingUnitsSize>(
-                           ex.linkingUnits.size() - 1u),
-                       static_cast<ExecutableHeader0x0::ActiveLinkingUnitIndex>(
-                           ex.activeLinkingUnitIndex));
-        assert(header0x0.isValid());
-        if (!(os << header0x0))
-            return os;
+    template <typename Header>
+    bool readHeader(Header & header) noexcept {
+        auto const data = read(sizeof(header));
+        return data && header.deserializeFrom(data);
     }
 
-    for (auto const & lu : ex.linkingUnits) {
-        {
-            ExecutableLinkingUnitHeader0x0 luHeader0x0;
-            using NSS = ExecutableLinkingUnitHeader0x0::NumSectionsSize;
-            luHeader0x0.init(static_cast<NSS>(lu.numberOfSections() - 1u));
-            if (!(os << luHeader0x0))
-                return os;
-        }
+    bool skip(std::size_t size) noexcept { return read(size) != nullptr; }
 
-        static_assert(std::is_pod<ExecutableSectionHeader0x0>::value, "");
-        if (lu.textSection) {
-            auto const & instructions = lu.textSection->instructions;
-            auto numInstructions = instructions.size();
-            if (!serializeSectionHeader(
-                    os,
-                    ExecutableSectionHeader0x0::SectionType::Text,
-                    numInstructions))
-                return os;
+    /* An upper bound of the number of items of the given size left: */
+    std::size_t maxItemsLeft(std::size_t itemSize) const noexcept
+    { return m_sizeLeft / itemSize; }
 
-            static constexpr auto const instructionsPerStreamSize =
-                    std::numeric_limits<std::streamsize>::max()
-                    / sizeof(SharemindCodeBlock);
-            static_assert(instructionsPerStreamSize > 0u, "");
-            auto writePtr = instructions.data();
-            while (numInstructions > instructionsPerStreamSize) {
-                auto const toWrite =
-                        instructionsPerStreamSize * sizeof(SharemindCodeBlock);
-                if (!os.write(reinterpret_cast<char const *>(writePtr),
-                              static_cast<std::streamsize>(toWrite)))
-                    return os;
-                writePtr += instructionsPerStreamSize;
-                numInstructions -= instructionsPerStreamSize;
-            }
-            auto const toWrite = numInstructions * sizeof(SharemindCodeBlock);
-            if (!os.write(reinterpret_cast<char const *>(writePtr),
-                          static_cast<std::streamsize>(toWrite)))
-                return os;
-        }
+    bool readInto(char * buffer, std::size_t size) noexcept {
+        auto const data = read(size);
+        if (!data)
+            return false;
+        std::memcpy(buffer, data, size);
+        return true;
+    }
 
-        using SectionType = ExecutableSectionHeader0x0::SectionType;
+private: /* Fields: */
 
-        if (lu.roDataSection
-            && !serializeRegularSection(
-                    os,
-                    SectionType::RoData,
-                    lu.roDataSection->data.get(),
-                    lu.roDataSection->sizeInBytes))
-            return os;
+    char const * const m_data;
+    char const * m_pos;
+    std::size_t m_sizeLeft;
 
-        if (lu.rwDataSection
-            && !serializeRegularSection(
-                    os,
-                    SectionType::Data,
-                    lu.rwDataSection->data.get(),
-                    lu.rwDataSection->sizeInBytes))
-            return os;
+};
 
-        if (lu.bssSection
-            && !serializeSectionHeader(os,
-                                       SectionType::Bss,
-                                       lu.bssSection->sizeInBytes))
-            return os;
+template <typename EmptyBindingException, typename DuplicateBindingException>
+void splitBindings(Executable::BindingsTable & bindings,
+                   char const * data,
+                   std::size_t size,
+                   std::size_t luIndex,
+                   std::size_t sectionIndex,
+                   char const * edesc)
+{
+    assert(size > 0u);
+    auto const end = data + size;
+    auto const nextNul =
+            [end](char const * const pos) noexcept {
+                auto const nul = static_cast<char const *>(
+                        std::memchr(pos,
+                                    '\0',
+                                    static_cast<std::size_t>(end - pos)));
+                return nul ? nul : end;
+            };
+
+    std::size_t numBindings = 0u;
+    for (auto pos = data; pos != end; ++numBindings) {
+        pos = nextNul(pos);
+        if (pos != end)
+            ++pos;
+    }
+    /* A final binding without a terminating NUL gets one appended: */
+    bindings.reserve(numBindings,
+                     (data[size - 1u] == '\0') ? size : size + 1u);
+
+    while (data != end) {
+        auto const bindingEnd = nextNul(data);
+        if (bindingEnd == data)
+            throw EmptyBindingException(
+                    concat("Invalid empty binding found in ", edesc,
+                           " section in linking unit ", luIndex,
+                           ", section ", sectionIndex, '!'));
+        std::string_view const bindName(
+                    data,
+                    static_cast<std::size_t>(bindingEnd - data));
+        if (!bindings.insert(bindName))
+            throw DuplicateBindingException(
+                    concat("Duplicate binding for \"", std::string(bindName),
+                           "\" found in ", edesc, " section in linking unit ",
+                           luIndex, ", section ", sectionIndex, '!'));
+        data = (bindingEnd != end) ? bindingEnd + 1 : end;
+    }
+}
+
+} // anonymous namespace
+
+namespace {
+
+using SectionType = Executable::TableOfContents::SectionType;
+using Compression = Executable::TableOfContents::Compression;
+
+constexpr std::size_t const maxHeaderSize =
+        std::max({sizeof(ExecutableCommonHeader),
+                  sizeof(ExecutableHeader0x0),
+                  sizeof(ExecutableHeader0x1),
+                  sizeof(ExecutableLinkingUnitHeader0x0),
+                  sizeof(ExecutableSectionHeader0x0),
+                  sizeof(ExecutableSectionHeader0x1)});
+
+constexpr std::size_t const maxCompressionBlockSize = 1u << 30u;
+
+/* See Executable::IncrementalParser::startSectionData(): */
+constexpr std::size_t const maxEagerSectionCapacity = 64u * 1024u * 1024u;
+
+char const * sectionDescription(SectionType type) noexcept {
+    switch (type) {
+    case SectionType::Text: return "text";
+    case SectionType::RoData: return "read-only data";
+    case SectionType::Data: return "read-write data";
+    case SectionType::Bss: return "BSS";
+    case SectionType::Bind: return "system call bindings";
+    case SectionType::PdBind: return "protection domain bindings";
+    default:
+        assert(type == SectionType::Debug);
+        return "debug";
+    }
+}
+
+void checkFileFormatVersion(std::size_t version) {
+    if (version > 0x1u)
+        throw Executable::FormatVersionNotSupportedException(
+                concat("Sharemind Executable file format version ", version,
+                       " not supported for deserialization!"));
+}
+
+std::size_t fileHeaderSize(std::size_t version) noexcept {
+    return (version == 0x0u)
+           ? sizeof(ExecutableHeader0x0)
+           : sizeof(ExecutableHeader0x1);
+}
+
+[[noreturn]] void throwFailedToDeserializeFileHeader(std::size_t version) {
+    if (version == 0x0u)
+        throw Executable::FailedToDeserializeFileHeader0x0Exception();
+    throw Executable::FailedToDeserializeFileHeader0x1Exception();
+}
+
+/*
+  Deserializes the file header specific to the file format version of the
+  given table of contents into it and returns the number of linking units:
+*/
+std::size_t deserializeFileHeader(Executable::TableOfContents & toc,
+                                  void const * data)
+{
+    auto const version = toc.fileFormatVersion;
+    if (version == 0x0u) {
+        ExecutableHeader0x0 exeHeader0x0;
+        if (!exeHeader0x0.deserializeFrom(data))
+            throwFailedToDeserializeFileHeader(version);
+        toc.activeLinkingUnitIndex = exeHeader0x0.activeLinkingUnitIndex();
+        toc.payloadAlignment = 8u;
+        return static_cast<std::size_t>(
+                    exeHeader0x0.numberOfLinkingUnitsMinusOne()) + 1u;
+    }
+    ExecutableHeader0x1 exeHeader0x1;
+    if (!exeHeader0x1.deserializeFrom(data))
+        throwFailedToDeserializeFileHeader(version);
+    toc.activeLinkingUnitIndex = exeHeader0x1.activeLinkingUnitIndex();
+    toc.payloadAlignment =
+            static_cast<std::size_t>(1u) << exeHeader0x1.payloadAlignmentLog2();
+    return static_cast<std::size_t>(
+                exeHeader0x1.numberOfLinkingUnitsMinusOne()) + 1u;
+}
+
+[[noreturn]] void throwFailedToDeserializeLinkingUnitHeader(
+        std::size_t luIndex)
+{
+    throw Executable::FailedToDeserializeLinkingUnitHeader0x0Exception(
+            concat("Failed to deserialize Sharemind executable file linking "
+                   "unit header specific to format version 0 for linking "
+                   "unit ", luIndex, "!"));
+}
+
+std::size_t sectionHeaderSize(std::size_t version) noexcept {
+    return (version == 0x0u)
+           ? sizeof(ExecutableSectionHeader0x0)
+           : sizeof(ExecutableSectionHeader0x1);
+}
+
+[[noreturn]] void throwFailedToDeserializeSectionHeader(
+        std::size_t version,
+        std::size_t luIndex,
+        std::size_t sectionIndex)
+{
+    auto message(concat("Failed to deserialize Sharemind executable file "
+                        "linking unit header specific to format version ",
+                        version, " for linking unit ", luIndex,
+                        " and section ", sectionIndex, "!"));
+    if (version == 0x0u)
+        throw Executable::FailedToDeserializeSectionHeader0x0Exception(
+                std::move(message));
+    throw Executable::FailedToDeserializeSectionHeader0x1Exception(
+            std::move(message));
+}
+
+[[noreturn]] void throwDuplicateSection(SectionType type,
+                                        std::size_t luIndex)
+{
+    using E = Executable;
+#define THROW_DUPLICATE_SECTION(eName,edesc) \
+    throw E::Multiple ## eName ## SectionsInLinkingUnitException( \
+            concat("Multiple " edesc " sections defined in linking unit ", \
+                   luIndex, '!'))
+    switch (type) {
+    case SectionType::Text: THROW_DUPLICATE_SECTION(Text, "text");
+    case SectionType::RoData:
+        THROW_DUPLICATE_SECTION(RoData, "read-only data");
+    case SectionType::Data:
+        THROW_DUPLICATE_SECTION(RwData, "read-write data");
+    case SectionType::Bss: THROW_DUPLICATE_SECTION(Bss, "BSS");
+    case SectionType::Bind:
+        THROW_DUPLICATE_SECTION(SyscallBind, "system call bindings");
+    case SectionType::PdBind:
+        THROW_DUPLICATE_SECTION(PdBind, "protection domain bindings");
+    default:
+        assert(type == SectionType::Debug);
+        THROW_DUPLICATE_SECTION(Debug, "debug");
+    }
+#undef THROW_DUPLICATE_SECTION
+}
+
+[[noreturn]] void throwFailedToReadSectionData(SectionType type,
+                                               std::size_t luIndex)
+{
+    using E = Executable;
+#define THROW_READ_FAILED(eName,edesc) \
+    throw E::FailedToRead ## eName ## SectionDataException( \
+            concat("Failed to read contents of " edesc " section in linking " \
+                   "unit ", luIndex, '!'))
+    switch (type) {
+    case SectionType::Text: THROW_READ_FAILED(Text, "text");
+    case SectionType::RoData: THROW_READ_FAILED(RoData, "read-only data");
+    case SectionType::Data: THROW_READ_FAILED(RwData, "read-write data");
+    case SectionType::Bind: THROW_READ_FAILED(Bind, "system call bindings");
+    case SectionType::PdBind:
+        THROW_READ_FAILED(PdBind, "protection domain bindings");
+    default:
+        assert(type == SectionType::Debug);
+        THROW_READ_FAILED(Debug, "debug");
+    }
+#undef THROW_READ_FAILED
+}
+
+[[noreturn]] void throwFailedToReadZeroPadding(std::size_t luIndex,
+                                               std::size_t sectionIndex)
+{
+    throw Executable::FailedToReadZeroPaddingException(
+            concat("Failed to read zero padding after linking unit ",
+                   luIndex, ", section ", sectionIndex, '!'));
+}
+
+void checkZeroPadding(char const * padding,
+                      std::size_t size,
+                      std::size_t luIndex,
+                      std::size_t sectionIndex)
+{
+    for (std::size_t i = 0u; i < size; ++i)
+        if (padding[i] != '\0')
+            throw Executable::InvalidZeroPaddingException(
+                    concat("Non-zero padding found after linking unit ",
+                           luIndex, ", section ", sectionIndex, '!'));
+}
+
+[[noreturn]] void throwSectionTooBig(SectionType type, std::size_t luIndex) {
+    throw Executable::SectionTooBigException(
+            concat("Size of ", sectionDescription(type),
+                   " section in linking unit ", luIndex, " is too big!"));
+}
+
+std::size_t sectionDataSizeInBytes(SectionType type,
+                                   std::size_t size,
+                                   std::size_t luIndex)
+{
+    if (type == SectionType::Bss)
+        return 0u;
+    if (type != SectionType::Text)
+        return size;
+    static constexpr auto const maxInstructions =
+            std::numeric_limits<std::size_t>::max()
+            / sizeof(SharemindCodeBlock);
+    if (size > maxInstructions)
+        throwSectionTooBig(type, luIndex);
+    return size * sizeof(SharemindCodeBlock);
+}
+
+/*
+  Deserializes the section header specific to the given file format version
+  into the type, size and storage fields of section:
+*/
+void deserializeSectionHeader(std::size_t version,
+                              void const * data,
+                              Executable::TableOfContents::Section & section,
+                              std::size_t luIndex,
+                              std::size_t sectionIndex)
+{
+    if (version == 0x0u) {
+        ExecutableSectionHeader0x0 sectionHeader0x0;
+        if (!sectionHeader0x0.deserializeFrom(data))
+            throwFailedToDeserializeSectionHeader(version,
+                                                  luIndex,
+                                                  sectionIndex);
+        section.type = sectionHeader0x0.type();
+        section.size = sectionHeader0x0.size();
+        section.compression = Compression::None;
+        section.blockSize = 0u;
+        section.hasChecksum = false;
+        section.checksum = 0u;
+    } else {
+        ExecutableSectionHeader0x1 sectionHeader0x1;
+        if (!sectionHeader0x1.deserializeFrom(data))
+            throwFailedToDeserializeSectionHeader(version,
+                                                  luIndex,
+                                                  sectionIndex);
+        section.type = sectionHeader0x1.type();
+        if (integralGreater(sectionHeader0x1.size(),
+                            std::numeric_limits<std::size_t>::max())
+            || integralGreater(sectionHeader0x1.storedSize(),
+                               std::numeric_limits<std::size_t>::max()))
+            throwSectionTooBig(section.type, luIndex);
+        section.size = static_cast<std::size_t>(sectionHeader0x1.size());
+        section.compression = sectionHeader0x1.compression();
+        section.blockSize = sectionHeader0x1.blockSize();
+        section.storedSizeInBytes =
+                static_cast<std::size_t>(sectionHeader0x1.storedSize());
+        section.hasChecksum = sectionHeader0x1.hasChecksum();
+        section.checksum = sectionHeader0x1.checksum();
+    }
+    assert(section.type != SectionType::Invalid);
+    section.dataSizeInBytes =
+            sectionDataSizeInBytes(section.type, section.size, luIndex);
+    if (section.compression == Compression::None)
+        section.storedSizeInBytes = section.dataSizeInBytes;
+}
+
+/* Stored contents are padded to a multiple of 8 bytes: */
+std::size_t sectionPaddingSize(
+        Executable::TableOfContents::Section const & section) noexcept
+{
+    return static_cast<std::size_t>(
+                extraPaddingSize[section.storedSizeInBytes % 8u]);
+}
+
+/* Non-empty payloads are preceded by zero padding to the payload alignment: */
+std::size_t alignmentPaddingSize(
+        Executable::TableOfContents::Section const & section,
+        std::size_t offset,
+        std::size_t payloadAlignment) noexcept
+{
+    assert(payloadAlignment > 0u);
+    assert(!(payloadAlignment & (payloadAlignment - 1u)));
+    if (!section.storedSizeInBytes)
+        return 0u;
+    return (payloadAlignment - (offset & (payloadAlignment - 1u)))
+           & (payloadAlignment - 1u);
+}
+
+template <typename Source>
+void readZeroPadding(Source & src,
+                     std::size_t size,
+                     std::size_t luIndex,
+                     std::size_t sectionIndex)
+{
+    char buffer[256u];
+    while (size) {
+        auto const toRead = std::min(size, sizeof(buffer));
+        if (!src.readInto(buffer, toRead))
+            throwFailedToReadZeroPadding(luIndex, sectionIndex);
+        checkZeroPadding(buffer, toRead, luIndex, sectionIndex);
+        size -= toRead;
+    }
+}
+
+void checkChecksum(Executable::TableOfContents::Section const & section,
+                   std::size_t luIndex,
+                   std::uint32_t checksum)
+{
+    assert(section.hasChecksum);
+    if (checksum != section.checksum)
+        throw Executable::ChecksumMismatchException(
+                concat("Checksum mismatch in ",
+                       sectionDescription(section.type),
+                       " section in linking unit ", luIndex, '!'));
+}
+
+template <typename Source>
+void scanTableOfContents(Executable::TableOfContents & toc, Source & src) {
+    using E = Executable;
+
+    toc.fileFormatVersion = static_cast<std::size_t>(-1);
+    toc.activeLinkingUnitIndex = static_cast<std::size_t>(-1);
+    toc.payloadAlignment = 8u;
+    toc.sizeInBytes = 0u;
+    auto & linkingUnits = toc.linkingUnits;
+    linkingUnits.clear();
+
+    ExecutableCommonHeader exeHeader;
+    if (!src.readHeader(exeHeader))
+        throw E::FailedToDeserializeFileHeaderException();
+
+    auto const version = exeHeader.fileFormatVersion();
+    toc.fileFormatVersion = version;
+    checkFileFormatVersion(version);
+
+    char buffer[maxHeaderSize];
+    if (!src.readInto(buffer, fileHeaderSize(version)))
+        throwFailedToDeserializeFileHeader(version);
+    std::size_t const numLinkingUnits = deserializeFileHeader(toc, buffer);
+    /* Do not trust the number of linking units for allocating memory: */
+    linkingUnits.reserve(
+            std::min(numLinkingUnits,
+                     src.maxItemsLeft(sizeof(ExecutableLinkingUnitHeader0x0))));
+
+    for (std::size_t luIndex = 0u; luIndex < numLinkingUnits; ++luIndex) {
+        linkingUnits.emplace_back();
+        auto & lu = linkingUnits.back();
+        lu.headerOffset = src.offset();
+
+        ExecutableLinkingUnitHeader0x0 luHeader0x0;
+        if (!src.readHeader(luHeader0x0))
+            throwFailedToDeserializeLinkingUnitHeader(luIndex);
+
+        std::size_t const numSections =
+                static_cast<std::size_t>(
+                    luHeader0x0.numberOfSectionsMinusOne()) + 1u;
+        lu.sections.reserve(numSections);
+        bool haveSection[static_cast<std::size_t>(SectionType::Count)] = {};
+
+        for (std::size_t sectionIndex = 0u;
+             sectionIndex < numSections;
+             ++sectionIndex)
+        {
+            lu.sections.emplace_back();
+            auto & section = lu.sections.back();
+            section.headerOffset = src.offset();
+
+            if (!src.readInto(buffer, sectionHeaderSize(version)))
+                throwFailedToDeserializeSectionHeader(version,
+                                                      luIndex,
+                                                      sectionIndex);
+            deserializeSectionHeader(version,
+                                     buffer,
+                                     section,
+                                     luIndex,
+                                     sectionIndex);
+
+            auto & seen = haveSection[static_cast<std::size_t>(section.type)];
+            if (seen)
+                throwDuplicateSection(section.type, luIndex);
+            seen = true;
+
+            readZeroPadding(src,
+                            alignmentPaddingSize(section,
+                                                 src.offset(),
+                                                 toc.payloadAlignment),
+                            luIndex,
+                            sectionIndex);
+
+            section.dataOffset = src.offset();
+            if (section.type == SectionType::Bss)
+                continue;
+
+            if (!src.skip(section.storedSizeInBytes))
+                throwFailedToReadSectionData(section.type, luIndex);
+
+            readZeroPadding(src,
+                            sectionPaddingSize(section),
+                            luIndex,
+                            sectionIndex);
+        } // Loop over sections in linking unit
+    } // Loop over linking units
+
+    toc.sizeInBytes = src.offset();
+}
+
+class IstreamSource {
+
+public: /* Methods: */
+
+    IstreamSource(IstreamSource &&) = delete;
+    IstreamSource(IstreamSource const &) = delete;
+
+    IstreamSource(std::istream & is)
+        : m_is(is)
+        , m_oldExceptions(is.exceptions())
+    { is.exceptions(std::ios_base::goodbit); }
+
+    ~IstreamSource() noexcept {
+        try {
+            m_is.exceptions(m_oldExceptions);
+        } catch (std::ios_base::failure const &) {}
+    }
+
+    std::size_t offset() const noexcept { return m_offset; }
+
+    template <typename Header>
+    bool readHeader(Header & header) {
+        char buffer[sizeof(header)];
+        return read(buffer, sizeof(buffer)) && header.deserializeFrom(buffer);
+    }
+
+    /* Skips the payload by seeking to and reading only its last byte. If
+       the stream is not seekable, falls back to reading the payload: */
+    bool skip(std::size_t size) {
+        if (!size)
+            return true;
+        static constexpr auto const maxSeek =
+                std::numeric_limits<std::streamoff>::max();
+        if (integralLessEqual(size - 1u, maxSeek)
+            && m_is.seekg(static_cast<std::streamoff>(size - 1u),
+                          std::ios_base::cur))
+        {
+            if (m_is.get() == std::istream::traits_type::eof())
+                return false;
+            m_offset += size;
+            return true;
+        }
+        m_is.clear(m_is.rdstate() & ~std::ios_base::failbit);
+
+        static constexpr auto const maxIgnore =
+                std::numeric_limits<std::streamsize>::max();
+        while (size) {
+            auto const toIgnore =
+                    integralGreater(size, maxIgnore)
+                    ? maxIgnore
+                    : static_cast<std::streamsize>(size);
+            if (!m_is.ignore(toIgnore) || m_is.gcount() != toIgnore)
+                return false;
+            size -= static_cast<std::size_t>(toIgnore);
+            m_offset += static_cast<std::size_t>(toIgnore);
+        }
+        return true;
+    }
+
+    /* The size of the rest of the stream is unknown: */
+    std::size_t maxItemsLeft(std::size_t) const noexcept { return 0u; }
+
+    bool readInto(char * buffer, std::size_t size)
+    { return read(buffer, size); }
+
+private: /* Methods: */
+
+    bool read(char * buffer, std::size_t size) {
+        assert(integralLessEqual(size,
+                                 std::numeric_limits<std::streamsize>::max()));
+        if (!m_is.read(buffer, static_cast<std::streamsize>(size)))
+            return false;
+        m_offset += size;
+        return true;
+    }
+
+private: /* Fields: */
+
+    std::istream & m_is;
+    std::ios_base::iostate const m_oldExceptions;
+    std::size_t m_offset = 0u;
+
+};
+
+} // anonymous namespace
+
+void Executable::TableOfContents::scan(std::istream & is) {
+    IstreamSource src(is);
+    return scanTableOfContents(*this, src);
+}
+
+void Executable::TableOfContents::scan(void const * data, std::size_t size) {
+    BufferSource src(data, size);
+    return scanTableOfContents(*this, src);
+}
+
+namespace {
+
+/*
+  Deserializes the contents of the given section from the given payload into
+  the respective section of lu, which is allocated with the given allocator.
+  If payloadOwner is set, read-only data and debug sections point into the
+  payload instead of copying it. Read-write data sections are always copied,
+  since instances modify them. If verify is set, the checksum of the section,
+  if present, is computed over the payload while reading it.
+*/
+void materializePayload(Executable::LinkingUnit & lu,
+                        Executable::TableOfContents::Section const & section,
+                        std::size_t luIndex,
+                        std::size_t sectionIndex,
+                        char const * payload,
+                        std::shared_ptr<void> const & payloadOwner,
+                        bool verify,
+                        Executable::allocator_type const & allocator)
+{
+    using E = Executable;
+
+    verify = verify && section.hasChecksum;
+
+#define MATERIALIZE_DATASECTION(sName,shareable) \
+    do { \
+        assert(!lu.sName ## Section); \
+        if (section.size <= 0u) \
+            break; \
+        if ((shareable) && payloadOwner) { \
+            if (verify) \
+                checkChecksum(section, \
+                              luIndex, \
+                              crc32c(0u, payload, section.size)); \
+            lu.sName ## Section = \
+                    allocateSection<E::DataSection>( \
+                        allocator, \
+                        std::shared_ptr<void>(payloadOwner, \
+                                              const_cast<char *>(payload)), \
+                        section.size); \
+        } else if (verify) { \
+            auto data(allocatePayload(section.size, allocator)); \
+            checkChecksum(section, \
+                          luIndex, \
+                          crc32cCopy(0u, data.get(), payload, section.size)); \
+            lu.sName ## Section = \
+                    allocateSection<E::DataSection>(allocator, \
+                                                    std::move(data), \
+                                                    section.size); \
+        } else { \
+            lu.sName ## Section = \
+                    allocateSection<E::DataSection>( \
+                        allocator, \
+                        payload, \
+                        section.size, \
+                        E::DataSection::CopyData, \
+                        allocator); \
+        } \
+    } while (false)
+#define MATERIALIZE_BINDSECTION(sName,eName,edesc) \
+    do { \
+        assert(!lu.sName ## Section); \
+        if (section.size <= 0u) \
+            break; \
+        if (verify) \
+            checkChecksum(section, \
+                          luIndex, \
+                          crc32c(0u, payload, section.size)); \
+        auto newSection( \
+                allocateSection<E::eName ## ingsSection>(allocator, \
+                                                         allocator)); \
+        splitBindings<E::Empty ## eName ## ingException, \
+                      E::Duplicate ## eName ## ingException>( \
+                newSection->sName, \
+                payload, \
+                section.size, \
+                luIndex, \
+                sectionIndex, \
+                edesc); \
+        lu.sName ## Section = std::move(newSection); \
+    } while (false)
+
+    switch (section.type) {
+    case SectionType::Text:
+        assert(!lu.textSection);
+        {
+            auto newSection(
+                    allocateSection<E::TextSection>(allocator, allocator));
+            auto & instructions = newSection->instructions;
+            instructions = makeDefaultInitializedVector(
+                               section.size,
+                               instructions.get_allocator());
+            if (verify) {
+                checkChecksum(section,
+                              luIndex,
+                              crc32cCopy(0u,
+                                         instructions.data(),
+                                         payload,
+                                         section.dataSizeInBytes));
+            } else {
+                std::memcpy(instructions.data(),
+                            payload,
+                            section.dataSizeInBytes);
+            }
+            lu.textSection = std::move(newSection);
+        }
+        break;
+    case SectionType::RoData:
+        MATERIALIZE_DATASECTION(roData, true);
+        break;
+    case SectionType::Data:
+        MATERIALIZE_DATASECTION(rwData, false);
+        break;
+    case SectionType::Bss:
+        assert(!lu.bssSection);
+        lu.bssSection =
+                allocateSection<E::BssSection>(allocator, section.size);
+        break;
+    case SectionType::Bind:
+        MATERIALIZE_BINDSECTION(syscallBindings,
+                                SyscallBind,
+                                "system call bindings");
+        break;
+    case SectionType::PdBind:
+        MATERIALIZE_BINDSECTION(pdBindings,
+                                PdBind,
+                                "protection domain bindings");
+        break;
+    default:
+        assert(section.type == SectionType::Debug);
+        MATERIALIZE_DATASECTION(debug, true);
+        break;
+    }
+#undef MATERIALIZE_BINDSECTION
+#undef MATERIALIZE_DATASECTION
+}
+
+/*
+  Validates the block table of a compressed section and decompresses its
+  blocks, which can be done in any order and concurrently:
+*/
+class CompressedSectionReader {
+
+public: /* Methods: */
+
+    CompressedSectionReader(
+            Executable::TableOfContents::Section const & section,
+            std::size_t luIndex,
+            char const * stored)
+        : m_section(section)
+        , m_luIndex(luIndex)
+        , m_stored(stored)
+    {
+        assert(section.compression == Compression::Zstd);
+        assert(section.blockSize > 0u);
+        auto const dataSize = section.dataSizeInBytes;
+        auto const storedSize = section.storedSizeInBytes;
+        auto const numBlocks =
+                dataSize / section.blockSize
+                + ((dataSize % section.blockSize) ? 1u : 0u);
+        using BlockSize = std::uint32_t;
+        if (numBlocks > storedSize / sizeof(BlockSize))
+            fail();
+
+        m_blockOffsets.reserve(numBlocks + 1u);
+        auto offset = numBlocks * sizeof(BlockSize);
+        m_blockOffsets.emplace_back(offset);
+        for (std::size_t i = 0u; i < numBlocks; ++i) {
+            BlockSize blockSize;
+            std::memcpy(&blockSize,
+                        stored + i * sizeof(BlockSize),
+                        sizeof(BlockSize));
+            blockSize = littleEndianToHost(blockSize);
+            if (blockSize > storedSize - offset)
+                fail();
+            offset += blockSize;
+            m_blockOffsets.emplace_back(offset);
+        }
+        if (offset != storedSize)
+            fail();
+    }
+
+    std::size_t numberOfBlocks() const noexcept
+    { return m_blockOffsets.size() - 1u; }
+
+    /* Decompresses the given block into its place in dest: */
+    void decompressBlock(std::size_t blockIndex, void * dest) const {
+        assert(blockIndex < numberOfBlocks());
+        auto const blockStart = blockIndex * m_section.blockSize;
+        auto const blockSize =
+                std::min(m_section.blockSize,
+                         m_section.dataSizeInBytes - blockStart);
+        auto const compressedStart = m_blockOffsets[blockIndex];
+        auto const r =
+                ::ZSTD_decompress(static_cast<char *>(dest) + blockStart,
+                                  blockSize,
+                                  m_stored + compressedStart,
+                                  m_blockOffsets[blockIndex + 1u]
+                                  - compressedStart);
+        if (::ZSTD_isError(r) || r != blockSize)
+            fail();
+    }
+
+    void decompress(void * dest) const {
+        for (std::size_t i = 0u; i < numberOfBlocks(); ++i)
+            decompressBlock(i, dest);
+    }
+
+    /* Verifies the checksum of the stored bytes, if present: */
+    void verifyChecksum() const {
+        if (m_section.hasChecksum)
+            checkChecksum(m_section,
+                          m_luIndex,
+                          crc32c(0u, m_stored, m_section.storedSizeInBytes));
+    }
+
+private: /* Methods: */
+
+    [[noreturn]] void fail() const {
+        throw Executable::FailedToDecompressSectionException(
+                concat("Failed to decompress contents of ",
+                       sectionDescription(m_section.type),
+                       " section in linking unit ", m_luIndex, '!'));
+    }
+
+private: /* Fields: */
+
+    Executable::TableOfContents::Section const & m_section;
+    std::size_t const m_luIndex;
+    char const * const m_stored;
+    std::vector<std::size_t> m_blockOffsets;
+
+};
+
+} // anonymous namespace
+
+void Executable::TableOfContents::materializeSection(
+        Executable::LinkingUnit & lu,
+        std::size_t luIndex,
+        std::size_t sectionIndex,
+        void const * data,
+        std::shared_ptr<void> const & dataOwner,
+        allocator_type const & allocator) const
+{
+    assert(luIndex < linkingUnits.size());
+    assert(sectionIndex < linkingUnits[luIndex].sections.size());
+    auto const & section = linkingUnits[luIndex].sections[sectionIndex];
+    auto const stored = static_cast<char const *>(data) + section.dataOffset;
+    if (section.compression == Compression::None)
+        return materializePayload(lu,
+                                  section,
+                                  luIndex,
+                                  sectionIndex,
+                                  stored,
+                                  dataOwner,
+                                  true,
+                                  allocator);
+
+    CompressedSectionReader const reader(section, luIndex, stored);
+    reader.verifyChecksum();
+    auto const decoded(allocatePayload(section.dataSizeInBytes, allocator));
+    reader.decompress(decoded.get());
+    materializePayload(lu,
+                       section,
+                       luIndex,
+                       sectionIndex,
+                       static_cast<char const *>(decoded.get()),
+                       decoded,
+                       false,
+                       allocator);
+}
+
+namespace {
+
+/* Runs tasks on the given executor, or directly if there is none: */
+class TaskGroup {
+
+public: /* Methods: */
+
+    TaskGroup(TaskGroup &&) = delete;
+    TaskGroup(TaskGroup const &) = delete;
+
+    TaskGroup(Executable::Executor const * executor) noexcept
+        : m_executor(executor)
+    {}
+
+    ~TaskGroup() noexcept { wait(); }
+
+    void run(std::function<void ()> task) {
+        if (!m_executor)
+            return task();
+        {
+            std::lock_guard<std::mutex> const guard(m_mutex);
+            ++m_pending;
+        }
+        try {
+            (*m_executor)(
+                    [this, task = std::move(task)]() noexcept {
+                        task();
+                        std::lock_guard<std::mutex> const guard(m_mutex);
+                        if (!--m_pending)
+                            m_cond.notify_all();
+                    });
+        } catch (...) {
+            std::lock_guard<std::mutex> const guard(m_mutex);
+            --m_pending;
+            throw;
+        }
+    }
+
+    void wait() noexcept {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this]() noexcept { return !m_pending; });
+    }
+
+private: /* Fields: */
+
+    Executable::Executor const * const m_executor;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::size_t m_pending = 0u;
+
+};
+
+void deserializeBuffer(Executable & ex,
+                       void const * data,
+                       std::size_t size,
+                       std::shared_ptr<void> const & dataOwner,
+                       Executable::Executor const * executor = nullptr)
+{
+    ex.fileFormatVersion = static_cast<std::size_t>(-1);
+    ex.linkingUnits.clear();
+    ex.activeLinkingUnitIndex = static_cast<std::size_t>(-1);
+
+    Executable::TableOfContents toc;
+    toc.scan(data, size);
+
+    auto const allocator(ex.get_allocator());
+    auto & linkingUnits = ex.linkingUnits;
+    linkingUnits.resize(toc.linkingUnits.size());
+    if (executor) {
+        struct SectionTask {
+            std::size_t luIndex;
+            std::size_t sectionIndex;
+            Executable::TableOfContents::Section const * section;
+            std::unique_ptr<CompressedSectionReader> reader;
+            std::shared_ptr<void> decoded;
+            std::exception_ptr error;
+        };
+        std::vector<SectionTask> sectionTasks;
+        for (std::size_t luIndex = 0u;
+             luIndex < linkingUnits.size();
+             ++luIndex)
+        {
+            auto const & sections = toc.linkingUnits[luIndex].sections;
+            for (std::size_t sectionIndex = 0u;
+                 sectionIndex < sections.size();
+                 ++sectionIndex)
+                sectionTasks.emplace_back(
+                        SectionTask{luIndex,
+                                    sectionIndex,
+                                    &sections[sectionIndex],
+                                    nullptr,
+                                    nullptr,
+                                    nullptr});
+        }
+        auto const image = static_cast<char const *>(data);
+
+        /*
+          Decompress the blocks of all compressed sections and verify their
+          checksums concurrently:
+        */
+        {
+            std::mutex errorMutex;
+            TaskGroup tasks(executor);
+            auto const runTask =
+                    [&tasks, &errorMutex](SectionTask & st, auto f) {
+                        tasks.run(
+                            [&st, &errorMutex, f]() noexcept {
+                                try {
+                                    f(*st.reader, st.decoded.get());
+                                } catch (...) {
+                                    std::lock_guard<std::mutex> const guard(
+                                                errorMutex);
+                                    if (!st.error)
+                                        st.error = std::current_exception();
+                                }
+                            });
+                    };
+            for (auto & st : sectionTasks) {
+                if (st.section->compression == Compression::None)
+                    continue;
+                try {
+                    st.reader = std::make_unique<CompressedSectionReader>(
+                                    *st.section,
+                                    st.luIndex,
+                                    image + st.section->dataOffset);
+                    st.decoded = allocatePayload(st.section->dataSizeInBytes,
+                                                 allocator);
+                } catch (...) {
+                    st.error = std::current_exception();
+                    continue;
+                }
+                if (st.section->hasChecksum)
+                    runTask(st,
+                            [](CompressedSectionReader const & reader, void *)
+                            { reader.verifyChecksum(); });
+                for (std::size_t i = 0u; i < st.reader->numberOfBlocks(); ++i)
+                    runTask(st,
+                            [i](CompressedSectionReader const & reader,
+                                void * dest)
+                            { reader.decompressBlock(i, dest); });
+            }
+        } // Waits for all tasks
+
+        /* Decode all sections concurrently: */
+        {
+            TaskGroup tasks(executor);
+            for (auto & st : sectionTasks) {
+                if (st.error)
+                    continue;
+                tasks.run(
+                    [&st, &linkingUnits, image, &dataOwner, &allocator]()
+                            noexcept
+                    {
+                        try {
+                            if (st.decoded) {
+                                materializePayload(
+                                        linkingUnits[st.luIndex],
+                                        *st.section,
+                                        st.luIndex,
+                                        st.sectionIndex,
+                                        static_cast<char const *>(
+                                            st.decoded.get()),
+                                        st.decoded,
+                                        false,
+                                        allocator);
+                            } else {
+                                materializePayload(
+                                        linkingUnits[st.luIndex],
+                                        *st.section,
+                                        st.luIndex,
+                                        st.sectionIndex,
+                                        image + st.section->dataOffset,
+                                        dataOwner,
+                                        true,
+                                        allocator);
+                            }
+                        } catch (...) {
+                            st.error = std::current_exception();
+                        }
+                    });
+            }
+        } // Waits for all tasks
+
+        for (auto const & st : sectionTasks)
+            if (st.error)
+                std::rethrow_exception(st.error);
+    } else {
+        for (std::size_t luIndex = 0u;
+             luIndex < linkingUnits.size();
+             ++luIndex)
+        {
+            auto const numSections =
+                    toc.linkingUnits[luIndex].sections.size();
+            for (std::size_t sectionIndex = 0u;
+                 sectionIndex < numSections;
+                 ++sectionIndex)
+                toc.materializeSection(linkingUnits[luIndex],
+                                       luIndex,
+                                       sectionIndex,
+                                       data,
+                                       dataOwner,
+                                       allocator);
+        }
+    }
+
+    ex.fileFormatVersion = toc.fileFormatVersion;
+    ex.activeLinkingUnitIndex = toc.activeLinkingUnitIndex;
+}
+
+class FileDescriptorGuard {
+
+public: /* Methods: */
+
+    FileDescriptorGuard(FileDescriptorGuard &&) = delete;
+    FileDescriptorGuard(FileDescriptorGuard const &) = delete;
+
+    FileDescriptorGuard(int fd) noexcept : m_fd(fd) {}
+    ~FileDescriptorGuard() noexcept { ::close(m_fd); }
+
+    int get() const noexcept { return m_fd; }
+
+private: /* Fields: */
+
+    int const m_fd;
+
+};
+
+int openFile(char const * filename) {
+    assert(filename);
+    int const fd = ::open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throwNested(std::system_error(errno, std::generic_category()),
+                    Executable::FailedToOpenFileException(
+                        concat("Failed to open file \"", filename, "\"!")));
+    return fd;
+}
+
+template <typename Exception>
+std::size_t regularFileSize(int fd, char const * filename) {
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0)
+        throwNested(std::system_error(errno, std::generic_category()),
+                    Exception(
+                        concat("Failed to stat file \"", filename, "\"!")));
+    if (!S_ISREG(st.st_mode))
+        throw Exception(concat("Can not load \"", filename,
+                               "\" since it is not a regular file!"));
+    if (integralGreater(st.st_size, std::numeric_limits<std::size_t>::max()))
+        throw Exception(
+                concat("File \"", filename, "\" is too big to be loaded!"));
+    return static_cast<std::size_t>(st.st_size);
+}
+
+std::shared_ptr<void> mapFileDescriptor(int fd,
+                                        char const * filename,
+                                        std::size_t & size)
+{
+    using E = Executable;
+
+    size = regularFileSize<E::FailedToMapFileException>(fd, filename);
+    if (!size)
+        return std::shared_ptr<void>();
+
+    /* The mapping is private and writable, hence modifications to the
+       sections of the executable trigger copy-on-write of only the affected
+       pages and are never written back to the file: */
+    auto const mapping = ::mmap(nullptr,
+                                size,
+                                PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE,
+                                fd,
+                                0);
+    if (mapping == MAP_FAILED)
+        throwNested(std::system_error(errno, std::generic_category()),
+                    E::FailedToMapFileException(
+                        concat("Failed to map file \"", filename, "\"!")));
+    try {
+        return std::shared_ptr<void>(
+                    mapping,
+                    [size](void * const ptr) noexcept { ::munmap(ptr, size); });
+    } catch (...) {
+        ::munmap(mapping, size);
+        throw;
+    }
+}
+
+/*
+  Opens the file and asks the kernel to start reading all of it into the page
+  cache in the background, so that the reads of many files being loaded
+  asynchronously are in flight concurrently before any of the loading tasks
+  start running:
+*/
+std::shared_ptr<FileDescriptorGuard> openFileWithReadahead(
+        char const * filename)
+{
+    int const fd = openFile(filename);
+    std::shared_ptr<FileDescriptorGuard> file;
+    try {
+        file = std::make_shared<FileDescriptorGuard>(fd);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    // Only a hint, hence failures are ignored:
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    return file;
+}
+
+/*
+  Reads the whole file into a temporary buffer, from which the executable is
+  then deserialized by copying, hence the executable does not refer to the
+  file afterwards:
+*/
+void deserializeFileDescriptorCopy(Executable & ex,
+                                   int fd,
+                                   char const * filename,
+                                   Executable::Executor const * executor)
+{
+    using E = Executable;
+
+    auto const size = regularFileSize<E::FailedToReadFileException>(fd,
+                                                                    filename);
+    auto const buffer(allocatePayload(size, E::allocator_type()));
+    auto const data = static_cast<char *>(buffer.get());
+    for (std::size_t offset = 0u; offset < size;) {
+        auto const r = ::pread(fd, data + offset, size - offset,
+                               static_cast<::off_t>(offset));
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            throwNested(std::system_error(errno, std::generic_category()),
+                        E::FailedToReadFileException(
+                            concat("Failed to read file \"", filename,
+                                   "\"!")));
+        }
+        if (r == 0)
+            throw E::FailedToReadFileException(
+                    concat("File \"", filename,
+                           "\" was truncated while reading it!"));
+        offset += static_cast<std::size_t>(r);
+    }
+    deserializeBuffer(ex, data ? data : "", size, nullptr, executor);
+}
+
+void deserializeFileDescriptor(Executable & ex,
+                               int fd,
+                               char const * filename,
+                               Executable::FileLoadMode mode,
+                               Executable::Executor const * executor)
+{
+    if (mode == Executable::FileLoadMode::Copy)
+        return deserializeFileDescriptorCopy(ex, fd, filename, executor);
+    assert(mode == Executable::FileLoadMode::Map);
+    std::size_t size;
+    auto mapping(mapFileDescriptor(fd, filename, size));
+    auto const dataPtr = mapping.get();
+    deserializeBuffer(ex, dataPtr ? dataPtr : "", size, mapping, executor);
+}
+
+Executable deserializeOpenFile(FileDescriptorGuard const & file,
+                               char const * filename,
+                               Executable::FileLoadMode mode)
+{
+    Executable ex;
+    deserializeFileDescriptor(ex, file.get(), filename, mode, nullptr);
+    return ex;
+}
+
+} // anonymous namespace
+
+std::shared_ptr<void> Executable::mapFile(char const * filename,
+                                          std::size_t & size)
+{
+    FileDescriptorGuard const fdGuard(openFile(filename));
+    return mapFileDescriptor(fdGuard.get(), filename, size);
+}
+
+void Executable::deserializeFrom(void const * data, std::size_t size) {
+    assert(data || !size);
+    deserializeBuffer(*this, data ? data : "", size, nullptr);
+}
+
+void Executable::deserializeFrom(std::shared_ptr<void> data, std::size_t size)
+{
+    assert(data || !size);
+    auto const dataPtr = data.get();
+    deserializeBuffer(*this, dataPtr ? dataPtr : "", size, data);
+}
+
+void Executable::deserializeFrom(void const * data,
+                                 std::size_t size,
+                                 Executor const & executor)
+{
+    assert(data || !size);
+    assert(executor);
+    deserializeBuffer(*this, data ? data : "", size, nullptr, &executor);
+}
+
+void Executable::deserializeFrom(std::shared_ptr<void> data,
+                                 std::size_t size,
+                                 Executor const & executor)
+{
+    assert(data || !size);
+    assert(executor);
+    auto const dataPtr = data.get();
+    deserializeBuffer(*this, dataPtr ? dataPtr : "", size, data, &executor);
+}
+
+void Executable::deserializeFromFile(char const * filename,
+                                     FileLoadMode mode)
+{
+    FileDescriptorGuard const fdGuard(openFile(filename));
+    deserializeFileDescriptor(*this, fdGuard.get(), filename, mode, nullptr);
+}
+
+void Executable::deserializeFromFile(char const * filename,
+                                     Executor const & executor,
+                                     FileLoadMode mode)
+{
+    assert(executor);
+    FileDescriptorGuard const fdGuard(openFile(filename));
+    deserializeFileDescriptor(*this, fdGuard.get(), filename, mode, &executor);
+}
+
+void Executable::deserializeFromFileDescriptor(int fd,
+                                               char const * filename,
+                                               FileLoadMode mode)
+{
+    assert(fd >= 0);
+    assert(filename);
+    deserializeFileDescriptor(*this, fd, filename, mode, nullptr);
+}
+
+std::future<Executable> Executable::deserializeFromFileAsync(
+        std::string filename,
+        FileLoadMode mode)
+{
+    std::shared_ptr<FileDescriptorGuard> file;
+    try {
+        file = openFileWithReadahead(filename.c_str());
+    } catch (...) {
+        std::promise<Executable> promise;
+        promise.set_exception(std::current_exception());
+        return promise.get_future();
+    }
+    return std::async(
+                std::launch::async,
+                [file = std::move(file),
+                 filename = std::move(filename),
+                 mode]()
+                { return deserializeOpenFile(*file, filename.c_str(), mode); });
+}
+
+std::future<Executable> Executable::deserializeFromFileAsync(
+        std::string filename,
+        Executor const & executor,
+        FileLoadMode mode)
+{
+    assert(executor);
+    auto promise(std::make_shared<std::promise<Executable> >());
+    auto result(promise->get_future());
+    try {
+        auto file(openFileWithReadahead(filename.c_str()));
+        executor(
+            [promise,
+             file = std::move(file),
+             filename = std::move(filename),
+             mode]() noexcept
+            {
+                try {
+                    promise->set_value(
+                                deserializeOpenFile(*file,
+                                                    filename.c_str(),
+                                                    mode));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+    } catch (...) {
+        promise->set_exception(std::current_exception());
+    }
+    return result;
+}
+
+Executable::IncrementalParser::IncrementalParser() { reset(); }
 
-        if (lu.syscallBindingsSection
-            && !serializeBindingsSection(
-                    os,
-                    SectionType::Bind,
-                    lu.syscallBindingsSection->syscallBindings))
-            return os;
+Executable::IncrementalParser::IncrementalParser(
+        allocator_type const & allocator)
+    : m_executable(allocator)
+{ reset(); }
 
-        if (lu.pdBindingsSection
-            && !serializeBindingsSection(os,
-                                         SectionType::PdBind,
-                                         lu.pdBindingsSection->pdBindings))
-            return os;
+Executable::IncrementalParser::IncrementalParser(IncrementalParser && move)
+        noexcept
+    : m_executable(std::move(move.m_executable))
+    , m_tableOfContents(std::move(move.m_tableOfContents))
+    , m_payload(std::move(move.m_payload))
+{ takeItemState(move); }
+
+Executable::IncrementalParser & Executable::IncrementalParser::operator=(
+        IncrementalParser && move)
+{
+    if (this != &move) {
+        m_executable = std::move(move.m_executable);
+        m_tableOfContents = std::move(move.m_tableOfContents);
+        m_payload = std::move(move.m_payload);
+        takeItemState(move);
+    }
+    return *this;
+}
+
+Executable::IncrementalParser::~IncrementalParser() noexcept = default;
+
+Executable::IncrementalParser::Status
+Executable::IncrementalParser::feed(void const * data, std::size_t size) {
+    auto input = static_cast<char const *>(data);
+    while (m_state != State::Done) {
+        auto const toCopy = std::min(m_itemCapacity - m_itemFill, size);
+        if (toCopy) {
+            if (m_checksumItem) {
+                m_checksum = crc32cCopy(m_checksum,
+                                        m_itemDest + m_itemFill,
+                                        input,
+                                        toCopy);
+            } else {
+                std::memcpy(m_itemDest + m_itemFill, input, toCopy);
+            }
+            m_itemFill += toCopy;
+            m_consumed += toCopy;
+            input += toCopy;
+            size -= toCopy;
+        }
+        if (m_itemFill < m_itemSize) {
+            if (m_itemFill < m_itemCapacity || !size)
+                return Status::NeedMoreData;
+            growItem();
+            continue;
+        }
+        completeItem();
+    }
+    return Status::Done;
+}
+
+Executable::IncrementalParser::Status
+Executable::IncrementalParser::status() const noexcept
+{ return (m_state == State::Done) ? Status::Done : Status::NeedMoreData; }
+
+void Executable::IncrementalParser::finish() const {
+    auto const luIndex = m_tableOfContents.linkingUnits.size() - 1u;
+    auto const sectionIndex = [this]() noexcept {
+        return m_tableOfContents.linkingUnits.back().sections.size() - 1u;
+    };
+    switch (m_state) {
+    case State::CommonHeader:
+        throw FailedToDeserializeFileHeaderException();
+    case State::FileHeader:
+        throwFailedToDeserializeFileHeader(
+                    m_tableOfContents.fileFormatVersion);
+    case State::LinkingUnitHeader:
+        throwFailedToDeserializeLinkingUnitHeader(luIndex);
+    case State::SectionHeader:
+        throwFailedToDeserializeSectionHeader(
+                    m_tableOfContents.fileFormatVersion,
+                    luIndex,
+                    sectionIndex());
+    case State::SectionData:
+        throwFailedToReadSectionData(
+                    m_tableOfContents.linkingUnits.back().sections.back().type,
+                    luIndex);
+    case State::AlignmentPadding:
+    case State::Padding:
+        throwFailedToReadZeroPadding(luIndex, sectionIndex());
+    case State::Done:
+        break;
+    }
+}
+
+void Executable::IncrementalParser::reset() noexcept {
+    m_executable.fileFormatVersion = static_cast<std::size_t>(-1);
+    m_executable.linkingUnits.clear();
+    m_executable.activeLinkingUnitIndex = static_cast<std::size_t>(-1);
+    m_tableOfContents.fileFormatVersion = static_cast<std::size_t>(-1);
+    m_tableOfContents.activeLinkingUnitIndex = static_cast<std::size_t>(-1);
+    m_tableOfContents.payloadAlignment = 8u;
+    m_tableOfContents.sizeInBytes = 0u;
+    m_tableOfContents.linkingUnits.clear();
+    m_consumed = 0u;
+    m_numLinkingUnits = 0u;
+    m_numSections = 0u;
+    m_payload.clear();
+    startItem(State::CommonHeader, m_buffer, sizeof(ExecutableCommonHeader));
+}
+
+/*
+  Copies the state of the current item and the counters from the given
+  parser. Headers and padding are read into the buffer of the parser itself,
+  so a destination pointing there is rebased onto our own buffer:
+*/
+void Executable::IncrementalParser::takeItemState(IncrementalParser & move)
+        noexcept
+{
+    m_state = move.m_state;
+    m_itemDest = move.m_itemDest;
+    m_itemSize = move.m_itemSize;
+    m_itemCapacity = move.m_itemCapacity;
+    m_itemFill = move.m_itemFill;
+    m_consumed = move.m_consumed;
+    m_numLinkingUnits = move.m_numLinkingUnits;
+    m_numSections = move.m_numSections;
+    std::copy(std::begin(move.m_haveSection),
+              std::end(move.m_haveSection),
+              m_haveSection);
+    m_checksumItem = move.m_checksumItem;
+    m_checksum = move.m_checksum;
+    std::memcpy(m_buffer, move.m_buffer, sizeof(m_buffer));
+    std::less<char const *> const before;
+    if (!before(m_itemDest, move.m_buffer)
+        && before(m_itemDest, move.m_buffer + sizeof(move.m_buffer)))
+        m_itemDest = m_buffer + (m_itemDest - move.m_buffer);
+}
+
+void Executable::IncrementalParser::startItem(State state,
+                                              void * dest,
+                                              std::size_t size) noexcept
+{
+    m_state = state;
+    m_itemDest = static_cast<char *>(dest);
+    m_itemSize = size;
+    m_itemCapacity = size;
+    m_itemFill = 0u;
+    m_checksumItem = false;
+    m_checksum = 0u;
+}
+
+void Executable::IncrementalParser::startLinkingUnit() {
+    m_tableOfContents.linkingUnits.emplace_back();
+    m_tableOfContents.linkingUnits.back().headerOffset = m_consumed;
+    m_executable.linkingUnits.emplace_back();
+    startItem(State::LinkingUnitHeader,
+              m_buffer,
+              sizeof(ExecutableLinkingUnitHeader0x0));
+}
+
+void Executable::IncrementalParser::startSection() {
+    auto & sections = m_tableOfContents.linkingUnits.back().sections;
+    sections.emplace_back();
+    sections.back().headerOffset = m_consumed;
+    startItem(State::SectionHeader,
+              m_buffer,
+              sectionHeaderSize(m_tableOfContents.fileFormatVersion));
+}
+
+void Executable::IncrementalParser::completeItem() {
+    switch (m_state) {
+    case State::CommonHeader: return completeCommonHeader();
+    case State::FileHeader: return completeFileHeader();
+    case State::LinkingUnitHeader: return completeLinkingUnitHeader();
+    case State::SectionHeader: return completeSectionHeader();
+    case State::AlignmentPadding: return completeAlignmentPadding();
+    case State::SectionData: return completeSectionData();
+    case State::Padding: return completePadding();
+    case State::Done: break;
+    }
+    assert(false);
+}
+
+void Executable::IncrementalParser::completeCommonHeader() {
+    ExecutableCommonHeader exeHeader;
+    if (!exeHeader.deserializeFrom(m_buffer))
+        throw FailedToDeserializeFileHeaderException();
+    auto const version = exeHeader.fileFormatVersion();
+    checkFileFormatVersion(version);
+    m_tableOfContents.fileFormatVersion = version;
+    m_executable.fileFormatVersion = version;
+    startItem(State::FileHeader, m_buffer, fileHeaderSize(version));
+}
+
+void Executable::IncrementalParser::completeFileHeader() {
+    m_numLinkingUnits = deserializeFileHeader(m_tableOfContents, m_buffer);
+    m_executable.activeLinkingUnitIndex =
+            m_tableOfContents.activeLinkingUnitIndex;
+    startLinkingUnit();
+}
+
+void Executable::IncrementalParser::completeLinkingUnitHeader() {
+    ExecutableLinkingUnitHeader0x0 luHeader0x0;
+    if (!luHeader0x0.deserializeFrom(m_buffer))
+        throwFailedToDeserializeLinkingUnitHeader(
+                    m_tableOfContents.linkingUnits.size() - 1u);
+    m_numSections =
+            static_cast<std::size_t>(
+                luHeader0x0.numberOfSectionsMinusOne()) + 1u;
+    m_tableOfContents.linkingUnits.back().sections.reserve(m_numSections);
+    std::fill(std::begin(m_haveSection), std::end(m_haveSection), false);
+    startSection();
+}
+
+void Executable::IncrementalParser::completeSectionHeader() {
+    auto const luIndex = m_tableOfContents.linkingUnits.size() - 1u;
+    auto & sections = m_tableOfContents.linkingUnits.back().sections;
+    auto & section = sections.back();
+    deserializeSectionHeader(m_tableOfContents.fileFormatVersion,
+                             m_buffer,
+                             section,
+                             luIndex,
+                             sections.size() - 1u);
+
+    auto & seen = m_haveSection[static_cast<std::size_t>(section.type)];
+    if (seen)
+        throwDuplicateSection(section.type, luIndex);
+    seen = true;
+
+    auto const paddingSize =
+            alignmentPaddingSize(section,
+                                 m_consumed,
+                                 m_tableOfContents.payloadAlignment);
+    if (paddingSize) {
+        m_payload.resize(paddingSize);
+        return startItem(State::AlignmentPadding,
+                         m_payload.data(),
+                         paddingSize);
+    }
+    startSectionData();
+}
+
+void Executable::IncrementalParser::completeAlignmentPadding() {
+    auto const & sections = m_tableOfContents.linkingUnits.back().sections;
+    checkZeroPadding(m_payload.data(),
+                     m_payload.size(),
+                     m_tableOfContents.linkingUnits.size() - 1u,
+                     sections.size() - 1u);
+    m_payload.clear();
+    startSectionData();
+}
+
+void Executable::IncrementalParser::startSectionData() {
+    auto & section = m_tableOfContents.linkingUnits.back().sections.back();
+    section.dataOffset = m_consumed;
+
+    /*
+      Storage for at most this many bytes of section contents is allocated
+      before the contents arrive. Beyond that, the storage is doubled as
+      needed, so that headers claiming huge sizes can not exhaust memory:
+    */
+    auto const capacity =
+            std::min(section.storedSizeInBytes, maxEagerSectionCapacity);
+
+    /* Compressed contents and bindings are decoded once read completely: */
+    if (section.compression != Compression::None
+        || section.type == SectionType::Bind
+        || section.type == SectionType::PdBind)
+    {
+        m_payload.resize(capacity);
+        startItem(State::SectionData,
+                  m_payload.data(),
+                  section.storedSizeInBytes);
+        m_itemCapacity = capacity;
+        m_checksumItem = section.hasChecksum;
+        return;
+    }
+
+    /* Set up the section so that its contents are read directly into it: */
+    auto & lu = m_executable.linkingUnits.back();
+    auto const allocator(m_executable.get_allocator());
+    void * dest = nullptr;
+    auto const newDataSection =
+            [capacity, &allocator, &dest]() {
+                auto data(allocatePayload(capacity, allocator));
+                dest = data.get();
+                return allocateSection<DataSection>(allocator,
+                                                    std::move(data),
+                                                    capacity);
+            };
+    switch (section.type) {
+    case SectionType::Text:
+        {
+            if (section.size > TextSection::Container().max_size())
+                throwSectionTooBig(section.type,
+                                   m_executable.linkingUnits.size() - 1u);
+            auto newSection(
+                    allocateSection<TextSection>(allocator, allocator));
+            auto & instructions = newSection->instructions;
+            instructions = makeDefaultInitializedVector(
+                               capacity / sizeof(SharemindCodeBlock),
+                               instructions.get_allocator());
+            dest = instructions.data();
+            lu.textSection = std::move(newSection);
+        }
+        break;
+    case SectionType::RoData:
+        if (section.size)
+            lu.roDataSection = newDataSection();
+        break;
+    case SectionType::Data:
+        if (section.size)
+            lu.rwDataSection = newDataSection();
+        break;
+    case SectionType::Bss:
+        lu.bssSection = allocateSection<BssSection>(allocator, section.size);
+        break;
+    default:
+        assert(section.type == SectionType::Debug);
+        if (section.size)
+            lu.debugSection = newDataSection();
+        break;
+    }
+    startItem(State::SectionData, dest, section.storedSizeInBytes);
+    m_itemCapacity = capacity;
+    m_checksumItem = section.hasChecksum;
+}
+
+void Executable::IncrementalParser::growItem() {
+    assert(m_state == State::SectionData);
+    assert(m_itemFill == m_itemCapacity);
+    assert(m_itemCapacity < m_itemSize);
+    auto const capacity =
+            (m_itemCapacity < m_itemSize - m_itemCapacity)
+            ? m_itemCapacity * 2u
+            : m_itemSize;
+    auto const & section =
+            m_tableOfContents.linkingUnits.back().sections.back();
+    if (section.compression != Compression::None
+        || section.type == SectionType::Bind
+        || section.type == SectionType::PdBind)
+    {
+        m_payload.resize(capacity);
+        m_itemDest = m_payload.data();
+        m_itemCapacity = capacity;
+        return;
+    }
+
+    auto & lu = m_executable.linkingUnits.back();
+    auto const growDataSection =
+            [this, capacity](DataSection & dataSection) {
+                auto data(allocatePayload(capacity,
+                                          m_executable.get_allocator()));
+                std::memcpy(data.get(), m_itemDest, m_itemFill);
+                m_itemDest = static_cast<char *>(data.get());
+                dataSection.data = std::move(data);
+                dataSection.sizeInBytes = capacity;
+            };
+    switch (section.type) {
+    case SectionType::Text:
+        {
+            auto & instructions = lu.textSection->instructions;
+            auto newInstructions(
+                    makeDefaultInitializedVector(
+                        capacity / sizeof(SharemindCodeBlock),
+                        instructions.get_allocator()));
+            std::memcpy(newInstructions.data(), m_itemDest, m_itemFill);
+            instructions = std::move(newInstructions);
+            m_itemDest = reinterpret_cast<char *>(instructions.data());
+        }
+        break;
+    case SectionType::RoData: growDataSection(*lu.roDataSection); break;
+    case SectionType::Data: growDataSection(*lu.rwDataSection); break;
+    default:
+        assert(section.type == SectionType::Debug);
+        growDataSection(*lu.debugSection);
+        break;
+    }
+    m_itemCapacity = capacity;
+}
+
+void Executable::IncrementalParser::completeSectionData() {
+    auto const luIndex = m_tableOfContents.linkingUnits.size() - 1u;
+    auto const & sections = m_tableOfContents.linkingUnits.back().sections;
+    auto const sectionIndex = sections.size() - 1u;
+    auto const & section = sections.back();
+    auto & lu = m_executable.linkingUnits.back();
+    auto const allocator(m_executable.get_allocator());
+
+    if (section.hasChecksum)
+        checkChecksum(section, luIndex, m_checksum);
+
+    if (section.compression != Compression::None) {
+        auto const decoded(allocatePayload(section.dataSizeInBytes,
+                                           allocator));
+        CompressedSectionReader(section, luIndex, m_payload.data())
+                .decompress(decoded.get());
+        materializePayload(lu,
+                           section,
+                           luIndex,
+                           sectionIndex,
+                           static_cast<char const *>(decoded.get()),
+                           decoded,
+                           false,
+                           allocator);
+    } else if (section.type == SectionType::Bind
+               || section.type == SectionType::PdBind)
+    {
+        materializePayload(lu,
+                           section,
+                           luIndex,
+                           sectionIndex,
+                           m_payload.data(),
+                           nullptr,
+                           false,
+                           allocator);
+    }
+    m_payload.clear();
+
+    startItem(State::Padding, m_buffer, sectionPaddingSize(section));
+}
+
+void Executable::IncrementalParser::completePadding() {
+    auto const luIndex = m_tableOfContents.linkingUnits.size() - 1u;
+    auto const sectionIndex =
+            m_tableOfContents.linkingUnits.back().sections.size() - 1u;
+    checkZeroPadding(m_buffer, m_itemSize, luIndex, sectionIndex);
+
+    if (sectionIndex + 1u < m_numSections)
+        return startSection();
+    if (luIndex + 1u < m_numLinkingUnits)
+        return startLinkingUnit();
+    m_tableOfContents.sizeInBytes = m_consumed;
+    startItem(State::Done, nullptr, 0u);
+}
+
+namespace {
+
+void checkSerializable(Executable const & ex,
+                       Executable::SerializationOptions const & options)
+{
+    using E = Executable;
+
+    if (options.fileFormatVersion > 0x1u)
+        throw Executable::FormatVersionNotSupportedException(
+                concat("Sharemind Executable file format version ",
+                       options.fileFormatVersion,
+                       " not supported for serialization!"));
+    if (options.compression != Compression::None) {
+        if (options.fileFormatVersion < 0x1u)
+            throw Executable::FormatVersionNotSupportedException(
+                    concat("Compression is not supported by Sharemind "
+                           "Executable file format version ",
+                           options.fileFormatVersion, '!'));
+        if (!options.compressionBlockSize
+            || options.compressionBlockSize > maxCompressionBlockSize)
+            throw E::InvalidCompressionBlockSizeException();
+    }
+    if (options.checksums && options.fileFormatVersion < 0x1u)
+        throw Executable::FormatVersionNotSupportedException(
+                concat("Checksums are not supported by Sharemind Executable "
+                       "file format version ",
+                       options.fileFormatVersion, '!'));
+    {
+        using H = ExecutableHeader0x1;
+        auto const alignment = options.payloadAlignment;
+        if (alignment < (1u << H::minPayloadAlignmentLog2)
+            || alignment > (1u << H::maxPayloadAlignmentLog2)
+            || (alignment & (alignment - 1u)))
+            throw E::InvalidPayloadAlignmentException();
+        if (alignment != 8u && options.fileFormatVersion < 0x1u)
+            throw Executable::FormatVersionNotSupportedException(
+                    concat("Payload alignment is not supported by Sharemind "
+                           "Executable file format version ",
+                           options.fileFormatVersion, '!'));
+    }
+
+    auto const version = options.fileFormatVersion;
+    if (ex.linkingUnits.empty())
+        throw E::NoLinkingUnitsDefinedException();
+    using NLUS0x0 = ExecutableHeader0x0::NumLinkingUnitsSize;
+    using NLUS0x1 = ExecutableHeader0x1::NumLinkingUnitsSize;
+    if ((version == 0x0u)
+        ? (ex.linkingUnits.size() - 1u > std::numeric_limits<NLUS0x0>::max())
+        : integralGreater(ex.linkingUnits.size() - 1u,
+                          std::numeric_limits<NLUS0x1>::max()))
+        throw E::TooManyLinkingUnitsDefinedException();
+    if (ex.activeLinkingUnitIndex >= ex.linkingUnits.size())
+        throw E::InvalidActiveLinkingUnitException();
+
+    for (auto const & lu : ex.linkingUnits) {
+        auto const numberOfSections = lu.numberOfSections();
+        if (!numberOfSections)
+            throw E::NoSectionsDefinedInLinkingUnitException();
+        using NSS = ExecutableLinkingUnitHeader0x0::NumSectionsSize;
+        if (numberOfSections - 1u > std::numeric_limits<NSS>::max())
+            throw E::TooManySectionsDefinedInLinkingUnitException();
+        if (lu.textSection)
+            checkSectionSize<E::TextSectionTooBigException>(
+                        lu.textSection->instructions.size(),
+                        version);
+        if (lu.roDataSection)
+            checkSectionSize<E::RoDataSectionTooBigException>(
+                        lu.roDataSection->sizeInBytes,
+                        version);
+        if (lu.rwDataSection)
+            checkSectionSize<E::RwDataSectionTooBigException>(
+                        lu.rwDataSection->sizeInBytes,
+                        version);
+        if (lu.bssSection)
+            checkSectionSize<E::BssSectionTooBigException>(
+                        lu.bssSection->sizeInBytes,
+                        version);
+        if (lu.syscallBindingsSection)
+            checkSectionSize<E::BindingsSectionTooBigException>(
+                    lu.syscallBindingsSection->syscallBindings.sizeInBytes(),
+                    version);
+        if (lu.pdBindingsSection)
+            checkSectionSize<E::PdBindingsSectionTooBigException>(
+                    lu.pdBindingsSection->pdBindings.sizeInBytes(),
+                    version);
+        if (lu.debugSection)
+            checkSectionSize<E::DebugSectionTooBigException>(
+                        lu.debugSection->sizeInBytes,
+                        version);
+    }
+}
+
+/* Calls f(type, size, data, dataSizeInBytes) for all sections in file order: */
+template <typename F>
+void forEachSection(Executable::LinkingUnit const & lu, F && f) {
+    if (lu.textSection) {
+        auto const & instructions = lu.textSection->instructions;
+        f(SectionType::Text,
+          instructions.size(),
+          instructions.data(),
+          instructions.size() * sizeof(SharemindCodeBlock));
+    }
+    if (lu.roDataSection)
+        f(SectionType::RoData,
+          lu.roDataSection->sizeInBytes,
+          lu.roDataSection->data.get(),
+          lu.roDataSection->sizeInBytes);
+    if (lu.rwDataSection)
+        f(SectionType::Data,
+          lu.rwDataSection->sizeInBytes,
+          lu.rwDataSection->data.get(),
+          lu.rwDataSection->sizeInBytes);
+    if (lu.bssSection)
+        f(SectionType::Bss, lu.bssSection->sizeInBytes, nullptr, 0u);
+    if (lu.syscallBindingsSection) {
+        auto const & bindings = lu.syscallBindingsSection->syscallBindings;
+        f(SectionType::Bind,
+          bindings.sizeInBytes(),
+          bindings.data(),
+          bindings.sizeInBytes());
+    }
+    if (lu.pdBindingsSection) {
+        auto const & bindings = lu.pdBindingsSection->pdBindings;
+        f(SectionType::PdBind,
+          bindings.sizeInBytes(),
+          bindings.data(),
+          bindings.sizeInBytes());
+    }
+    if (lu.debugSection)
+        f(SectionType::Debug,
+          lu.debugSection->sizeInBytes,
+          lu.debugSection->data.get(),
+          lu.debugSection->sizeInBytes);
+}
+
+using Buffer = std::shared_ptr<std::vector<char> const>;
+
+std::shared_ptr<std::vector<char> > compressBlock(
+        SectionType type,
+        char const * data,
+        std::size_t size,
+        int level)
+{
+    auto block(std::make_shared<std::vector<char> >(
+                   ::ZSTD_compressBound(size)));
+    auto const r =
+            ::ZSTD_compress(block->data(), block->size(), data, size, level);
+    if (::ZSTD_isError(r))
+        throw Executable::FailedToCompressSectionException(
+                concat("Failed to compress contents of ",
+                       sectionDescription(type), " section: ",
+                       ::ZSTD_getErrorName(r)));
+    block->resize(r);
+    return block;
+}
+
+void writeChunks(int fd, ::iovec * chunks, std::size_t numChunks) {
+    static std::size_t const maxChunksPerCall =
+            []() noexcept {
+                auto const iovMax = ::sysconf(_SC_IOV_MAX);
+                return (iovMax > 0) ? static_cast<std::size_t>(iovMax) : 16u;
+            }();
+
+    while (numChunks) {
+        auto const r =
+                ::writev(fd,
+                         chunks,
+                         static_cast<int>(std::min(numChunks,
+                                                   maxChunksPerCall)));
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            throwNested(std::system_error(errno, std::generic_category()),
+                        Executable::FailedToWriteException(
+                            "Failed to write Sharemind executable!"));
+        }
+
+        /* Skip fully written chunks and adjust the partially written one: */
+        auto written = static_cast<std::size_t>(r);
+        while (numChunks && written >= chunks->iov_len) {
+            written -= chunks->iov_len;
+            ++chunks;
+            --numChunks;
+        }
+        if (written) {
+            assert(numChunks);
+            chunks->iov_base = static_cast<char *>(chunks->iov_base) + written;
+            chunks->iov_len -= written;
+        }
+    }
+}
+
+} // anonymous namespace
+
+Executable::SerializationPlan::SerializationPlan(Executable const & ex)
+    : SerializationPlan(
+          ex,
+          [&ex]() noexcept {
+              SerializationOptions options;
+              options.fileFormatVersion = ex.fileFormatVersion;
+              return options;
+          }(),
+          nullptr)
+{}
+
+Executable::SerializationPlan::SerializationPlan(
+        Executable const & ex,
+        SerializationOptions const & options)
+    : SerializationPlan(ex, options, nullptr)
+{}
+
+Executable::SerializationPlan::SerializationPlan(
+        Executable const & ex,
+        SerializationOptions const & options,
+        Executor const & executor)
+    : SerializationPlan(ex, options, &executor)
+{}
+
+Executable::SerializationPlan::SerializationPlan(
+        Executable const & ex,
+        SerializationOptions const & options,
+        Executor const * executor)
+{
+    checkSerializable(ex, options);
+    auto const version = options.fileFormatVersion;
+
+    struct PlannedSection {
+        SectionType type;
+        std::size_t size;
+        void const * data;
+        std::size_t dataSizeInBytes;
+
+        /* The block table followed by the blocks, if compressed: */
+        std::vector<Buffer> compressed;
+        std::size_t storedSizeInBytes;
+        std::uint32_t checksum;
+        std::exception_ptr error;
+    };
+    std::vector<PlannedSection> sections;
+    for (auto const & lu : ex.linkingUnits)
+        forEachSection(
+                lu,
+                [&sections](SectionType type,
+                            std::size_t size,
+                            void const * data,
+                            std::size_t dataSizeInBytes)
+                {
+                    sections.emplace_back(
+                            PlannedSection{type,
+                                           size,
+                                           data,
+                                           dataSizeInBytes,
+                                           {},
+                                           dataSizeInBytes,
+                                           0u,
+                                           nullptr});
+                });
+
+    if (options.compression != Compression::None) {
+        auto const blockSize = options.compressionBlockSize;
+        {
+            std::mutex errorMutex;
+            TaskGroup tasks(executor);
+            for (auto & ps : sections) {
+                if (!ps.dataSizeInBytes)
+                    continue;
+                auto const numBlocks =
+                        ps.dataSizeInBytes / blockSize
+                        + ((ps.dataSizeInBytes % blockSize) ? 1u : 0u);
+                ps.compressed.resize(numBlocks + 1u);
+                for (std::size_t i = 0u; i < numBlocks; ++i)
+                    tasks.run(
+                        [&ps, &options, &errorMutex, blockSize, i]() noexcept
+                        {
+                            auto const blockStart = i * blockSize;
+                            try {
+                                ps.compressed[i + 1u] =
+                                        compressBlock(
+                                            ps.type,
+                                            static_cast<char const *>(ps.data)
+                                            + blockStart,
+                                            std::min(blockSize,
+                                                     ps.dataSizeInBytes
+                                                     - blockStart),
+                                            options.compressionLevel);
+                            } catch (...) {
+                                std::lock_guard<std::mutex> const guard(
+                                            errorMutex);
+                                if (!ps.error)
+                                    ps.error = std::current_exception();
+                            }
+                        });
+            }
+        } // Waits for all tasks
+
+        for (auto & ps : sections) {
+            if (ps.error)
+                std::rethrow_exception(ps.error);
+            if (ps.compressed.empty())
+                continue;
+            using BlockSize = std::uint32_t;
+            auto const numBlocks = ps.compressed.size() - 1u;
+            auto table(std::make_shared<std::vector<char> >(
+                           numBlocks * sizeof(BlockSize)));
+            auto storedSize = table->size();
+            for (std::size_t i = 0u; i < numBlocks; ++i) {
+                auto const compressedSize = ps.compressed[i + 1u]->size();
+                assert(compressedSize
+                       <= std::numeric_limits<BlockSize>::max());
+                auto const blockSizeLe =
+                        hostToLittleEndian(
+                            static_cast<BlockSize>(compressedSize));
+                std::memcpy(table->data() + i * sizeof(BlockSize),
+                            &blockSizeLe,
+                            sizeof(BlockSize));
+                storedSize += compressedSize;
+            }
+            /* Store sections which do not get smaller uncompressed: */
+            if (storedSize >= ps.dataSizeInBytes) {
+                ps.compressed.clear();
+                continue;
+            }
+            ps.compressed.front() = std::move(table);
+            ps.storedSizeInBytes = storedSize;
+        }
+    }
+
+    if (options.checksums) {
+        TaskGroup tasks(executor);
+        for (auto & ps : sections)
+            tasks.run(
+                [&ps]() noexcept {
+                    if (ps.compressed.empty()) {
+                        ps.checksum = crc32c(0u, ps.data, ps.dataSizeInBytes);
+                    } else {
+                        for (auto const & buffer : ps.compressed)
+                            ps.checksum = crc32c(ps.checksum,
+                                                 buffer->data(),
+                                                 buffer->size());
+                    }
+                });
+    }
+
+    m_headers.resize(sizeof(ExecutableCommonHeader)
+                     + fileHeaderSize(version)
+                     + ex.linkingUnits.size()
+                       * sizeof(ExecutableLinkingUnitHeader0x0)
+                     + sections.size() * sectionHeaderSize(version));
+    m_chunks.reserve(2u + ex.linkingUnits.size() + sections.size() * 4u);
+    m_tableOfContents.fileFormatVersion = version;
+    m_tableOfContents.activeLinkingUnitIndex = ex.activeLinkingUnitIndex;
+    m_tableOfContents.payloadAlignment = options.payloadAlignment;
+    m_tableOfContents.linkingUnits.reserve(ex.linkingUnits.size());
+
+    /* All offsets are multiples of 8, hence so is any alignment padding: */
+    char const * alignmentPadding = extraPadding;
+    if (options.payloadAlignment > 8u) {
+        auto zeros(std::make_shared<std::vector<char> const>(
+                       options.payloadAlignment - 8u));
+        alignmentPadding = zeros->data();
+        m_buffers.emplace_back(std::move(zeros));
+    }
+
+    auto headerPtr = m_headers.data();
+    std::size_t offset = 0u;
+    auto const addChunk =
+            [this, &offset](void const * data, std::size_t size) {
+                if (size)
+                    m_chunks.emplace_back(Chunk{data, size});
+                offset += size;
+            };
+    auto const addHeader =
+            [&headerPtr, &addChunk](auto const & header) {
+                header.serializeTo(headerPtr);
+                addChunk(headerPtr, sizeof(header));
+                headerPtr += sizeof(header);
+            };
+    auto const addSection =
+            [this,
+             version,
+             &options,
+             alignmentPadding,
+             &offset,
+             &addHeader,
+             &addChunk](PlannedSection & ps,
+                         TableOfContents::Section & section)
+            {
+                section.type = ps.type;
+                section.size = ps.size;
+                section.headerOffset = offset;
+                section.dataSizeInBytes = ps.dataSizeInBytes;
+                section.storedSizeInBytes = ps.storedSizeInBytes;
+
+                if (version == 0x0u) {
+                    using SS = ExecutableSectionHeader0x0::SizeType;
+                    assert(ps.size <= std::numeric_limits<SS>::max());
+                    ExecutableSectionHeader0x0 sectionHeader0x0;
+                    sectionHeader0x0.init(ps.type, static_cast<SS>(ps.size));
+                    assert(sectionHeader0x0.isValid());
+                    addHeader(sectionHeader0x0);
+                } else {
+                    using H = ExecutableSectionHeader0x1;
+                    if (!ps.compressed.empty()) {
+                        section.compression = Compression::Zstd;
+                        section.blockSize = options.compressionBlockSize;
+                    }
+                    H sectionHeader0x1;
+                    sectionHeader0x1.init(
+                                ps.type,
+                                static_cast<H::SizeType>(ps.size),
+                                static_cast<H::StoredSizeType>(
+                                    section.storedSizeInBytes),
+                                section.compression,
+                                static_cast<H::BlockSizeType>(
+                                    section.blockSize));
+                    if (options.checksums) {
+                        section.hasChecksum = true;
+                        section.checksum = ps.checksum;
+                        sectionHeader0x1.setChecksum(ps.checksum);
+                    }
+                    assert(sectionHeader0x1.isValid());
+                    addHeader(sectionHeader0x1);
+                }
+
+                auto const paddingSize =
+                        alignmentPaddingSize(section,
+                                             offset,
+                                             options.payloadAlignment);
+                assert(paddingSize <= options.payloadAlignment - 8u);
+                addChunk(alignmentPadding, paddingSize);
+
+                section.dataOffset = offset;
+                if (ps.compressed.empty()) {
+                    addChunk(ps.data, ps.dataSizeInBytes);
+                } else {
+                    for (auto & buffer : ps.compressed) {
+                        addChunk(buffer->data(), buffer->size());
+                        m_buffers.emplace_back(std::move(buffer));
+                    }
+                }
+                addChunk(extraPadding, sectionPaddingSize(section));
+            };
+
+    {
+        ExecutableCommonHeader header;
+        header.init(static_cast<ExecutableCommonHeader::FileFormatVersionType>(
+                        version));
+        assert(header.isValid());
+        addHeader(header);
+    }
+
+    if (version == 0x0u) {
+        ExecutableHeader0x0 header0x0;
+        header0x0.init(static_cast<ExecutableHeader0x0::NumLinkingUnitsSize>(
+                           ex.linkingUnits.size() - 1u),
+                       static_cast<ExecutableHeader0x0::ActiveLinkingUnitIndex>(
+                           ex.activeLinkingUnitIndex));
+        assert(header0x0.isValid());
+        addHeader(header0x0);
+    } else {
+        ExecutableHeader0x1 header0x1;
+        header0x1.init(static_cast<ExecutableHeader0x1::NumLinkingUnitsSize>(
+                           ex.linkingUnits.size() - 1u),
+                       static_cast<ExecutableHeader0x1::ActiveLinkingUnitIndex>(
+                           ex.activeLinkingUnitIndex),
+                       static_cast<ExecutableHeader0x1::PayloadAlignmentLog2>(
+                           __builtin_ctzll(options.payloadAlignment)));
+        assert(header0x1.isValid());
+        addHeader(header0x1);
+    }
+
+    auto plannedSection = sections.begin();
+    for (auto const & lu : ex.linkingUnits) {
+        m_tableOfContents.linkingUnits.emplace_back();
+        auto & tocLu = m_tableOfContents.linkingUnits.back();
+        tocLu.headerOffset = offset;
+        auto const numSections = lu.numberOfSections();
+        {
+            ExecutableLinkingUnitHeader0x0 luHeader0x0;
+            using NSS = ExecutableLinkingUnitHeader0x0::NumSectionsSize;
+            luHeader0x0.init(static_cast<NSS>(numSections - 1u));
+            addHeader(luHeader0x0);
+        }
+
+        tocLu.sections.resize(numSections);
+        for (auto & section : tocLu.sections)
+            addSection(*plannedSection++, section);
+    }
+    assert(plannedSection == sections.end());
+    assert(headerPtr == m_headers.data() + m_headers.size());
+    m_tableOfContents.sizeInBytes = offset;
+}
+
+Executable::SerializationPlan::SerializationPlan(SerializationPlan &&) noexcept
+        = default;
+
+Executable::SerializationPlan::SerializationPlan(SerializationPlan const & copy)
+    : m_headers(copy.m_headers)
+    , m_buffers(copy.m_buffers)
+    , m_chunks(copy.m_chunks)
+    , m_tableOfContents(copy.m_tableOfContents)
+{
+    /* Rebase the chunks which refer to the headers of the copied plan: */
+    auto const oldBegin = copy.m_headers.data();
+    auto const oldEnd = oldBegin + copy.m_headers.size();
+    for (auto & chunk : m_chunks) {
+        auto const data = static_cast<char const *>(chunk.data);
+        if (std::less_equal<char const *>()(oldBegin, data)
+            && std::less<char const *>()(data, oldEnd))
+            chunk.data = m_headers.data() + (data - oldBegin);
+    }
+}
+
+Executable::SerializationPlan & Executable::SerializationPlan::operator=(
+        SerializationPlan &&) noexcept = default;
+
+Executable::SerializationPlan & Executable::SerializationPlan::operator=(
+        SerializationPlan const & copy)
+{
+    if (this != &copy)
+        (*this) = SerializationPlan(copy);
+    return *this;
+}
+
+Executable::SerializationPlan::~SerializationPlan() noexcept = default;
+
+std::size_t Executable::SerializationPlan::writeTo(void * buffer,
+                                                  std::size_t size)
+        const noexcept
+{
+    auto const sizeNeeded = sizeInBytes();
+    if (size < sizeNeeded)
+        return sizeNeeded;
+    auto out = static_cast<char *>(buffer);
+    for (auto const & chunk : m_chunks) {
+        std::memcpy(out, chunk.data, chunk.size);
+        out += chunk.size;
+    }
+    assert(out == static_cast<char *>(buffer) + sizeNeeded);
+    return sizeNeeded;
+}
+
+void Executable::SerializationPlan::writeTo(int fd) const {
+    std::vector<::iovec> iovecs;
+    iovecs.reserve(m_chunks.size());
+    for (auto const & chunk : m_chunks)
+        iovecs.emplace_back(
+                ::iovec{const_cast<void *>(chunk.data), chunk.size});
+    writeChunks(fd, iovecs.data(), iovecs.size());
+}
 
-        if (lu.debugSection
-            && !serializeRegularSection(
-                    os,
-                    ExecutableSectionHeader0x0::SectionType::Debug,
-                    lu.debugSection->data.get(),
-                    lu.debugSection->sizeInBytes))
+std::ostream & Executable::SerializationPlan::writeTo(std::ostream & os) const
+{
+    static constexpr auto const maxWrite =
+            std::numeric_limits<std::streamsize>::max();
+    for (auto const & chunk : m_chunks) {
+        auto data = static_cast<char const *>(chunk.data);
+        auto size = chunk.size;
+        while (integralGreater(size, maxWrite)) {
+            if (!os.write(data, maxWrite))
+                return os;
+            size -= maxWrite;
+            data += maxWrite;
+        }
+        if (!os.write(data, static_cast<std::streamsize>(size)))
             return os;
     }
     return os;
 }
 
+namespace {
+
+/* Reads the rest of a Sharemind Executable whose common header was already
+   read from the stream: */
+std::istream & istreamDeserializeIncrementally(
+        std::istream & is,
+        Executable & ex,
+        ExecutableCommonHeader const & header)
+{
+    using Status = Executable::IncrementalParser::Status;
+    Executable::IncrementalParser parser(ex.get_allocator());
+    std::vector<char> buffer(64u * 1024u);
+    header.serializeTo(buffer.data());
+    try {
+        parser.feed(buffer.data(), sizeof(header));
+        while (parser.status() == Status::NeedMoreData) {
+            auto const toRead =
+                    std::min(parser.bytesNeeded(), buffer.size());
+            try {
+                if (!is.read(buffer.data(),
+                             static_cast<std::streamsize>(toRead)))
+                {
+                    parser.finish();
+                    return is;
+                }
+            } catch (std::ios_base::failure const & e) {
+                try {
+                    parser.finish();
+                } catch (...) {
+                    std::throw_with_nested(e);
+                }
+                throw;
+            }
+            parser.feed(buffer.data(), toRead);
+        }
+    } catch (std::ios_base::failure const &) {
+        throw;
+    } catch (...) {
+        return istreamSetFailure(is, std::current_exception());
+    }
+    ex = std::move(parser.executable());
+    return is;
+}
+
+} // anonymous namespace
+
+void Executable::serializeToFileDescriptor(int fd) const
+{ SerializationPlan(*this).writeTo(fd); }
+
+std::size_t Executable::serializeTo(void * buffer, std::size_t size) const
+{ return SerializationPlan(*this).writeTo(buffer, size); }
+
+} // namespace sharemind
+
+std::ostream & operator<<(std::ostream & os, sharemind::Executable const & ex)
+{ return sharemind::Executable::SerializationPlan(ex).writeTo(os); }
+
 std::istream & operator>>(std::istream & is, sharemind::Executable & ex) {
     using namespace sharemind;
     using E = Executable;
@@ -808,7 +3241,7 @@ std::istream & operator>>(std::istream & is, sharemind::Executable & ex) {
                 <= std::numeric_limits<decltype(ex.fileFormatVersion)>::max(),
                 "");
         ex.fileFormatVersion = version;
-        if (version > 0u)
+        if (version > 1u)
             return istreamSetFailure(
                     is,
                     [version]() {
@@ -819,230 +3252,5 @@ std::istream & operator>>(std::istream & is, sharemind::Executable & ex) {
                     });
     }
 
-    ExecutableHeader0x0 exeHeader0x0;
-    istreamReadValue<E::FailedToDeserializeFileHeader0x0Exception>(
-                is,
-                exeHeader0x0);
-
-    ex.activeLinkingUnitIndex = exeHeader0x0.activeLinkingUnitIndex();
-
-    static std::size_t const extraPadding[8] =
-            { 0u, 7u, 6u, 5u, 4u, 3u, 2u, 1u };
-    char extraPaddingBuffer[8u];
-
-    auto lusLeftMinusOne = exeHeader0x0.numberOfLinkingUnitsMinusOne();
-
-    static_assert(std::numeric_limits<decltype(lusLeftMinusOne)>::max()
-                  < std::numeric_limits<std::size_t>::max(), "");
-    auto & linkingUnits = ex.linkingUnits;
-    linkingUnits.reserve(static_cast<std::size_t>(lusLeftMinusOne) + 1u);
-
-    std::size_t luIndex = 0u;
-    for (;; --lusLeftMinusOne, ++luIndex) {
-        ExecutableLinkingUnitHeader0x0 luHeader0x0;
-        istreamReadValue(
-                is,
-                luHeader0x0,
-                [luIndex]() {
-                    return E::FailedToDeserializeLinkingUnitHeader0x0Exception(
-                        concat("Failed to deserialize Sharemind executable "
-                               "file linking unit header specific to "
-                               "format version 0 for linking unit ",
-                               luIndex, "!"));
-                });
-
-        #if __cplusplus >= 201703L
-        auto & lu = linkingUnits.emplace_back();
-        #else
-        linkingUnits.emplace_back();
-        auto & lu = linkingUnits.back();
-        #endif
-
-        auto sectionsLeftMinusOne = luHeader0x0.numberOfSectionsMinusOne();
-        static_assert(std::numeric_limits<decltype(sectionsLeftMinusOne)>::max()
-                      < std::numeric_limits<std::size_t>::max(), "");
-        std::size_t sectionIndex = 0u;
-
-        for (;; --sectionsLeftMinusOne, ++sectionIndex) {
-            ExecutableSectionHeader0x0 sectionHeader0x0;
-            istreamReadValue(
-                    is,
-                    sectionHeader0x0,
-                    [luIndex, sectionIndex]() {
-                        return E::FailedToDeserializeSectionHeader0x0Exception(
-                            concat("Failed to deserialize Sharemind executable "
-                                   "file linking unit header specific to "
-                                   "format version 0 for linking unit ",
-                                   luIndex, " and section ", sectionIndex,
-                                   "!"));
-                    });
-
-            auto const sectionType = sectionHeader0x0.type();
-            assert(sectionType
-                   != ExecutableSectionHeader0x0::SectionType::Invalid);
-
-            auto const sectionSize = sectionHeader0x0.size();
-            static_assert(std::numeric_limits<decltype(sectionSize)>::max()
-                          <= std::numeric_limits<std::size_t>::max(), "");
-
-#define READ_AND_CHECK_ZERO_PADDING \
-    do { \
-        auto const paddingSize(extraPadding[sectionSize % 8]); \
-        assert(sizeof(extraPaddingBuffer) >= paddingSize); \
-        static_assert(std::numeric_limits<std::streamsize>::max() >= 8, \
-                      ""); \
-        if (!istreamReadRawData( \
-                    is, \
-                    extraPaddingBuffer, \
-                    static_cast<std::streamsize>(paddingSize), \
-                    [luIndex, sectionIndex]() { \
-                        return E::FailedToReadZeroPaddingException( \
-                            concat("Failed to read zero padding after " \
-                                   "linking unit ", luIndex, ", section ", \
-                                   sectionIndex, '!')); \
-                    })) \
-            return is; \
-        for (unsigned i = 0u; i < paddingSize; ++i) \
-            if (extraPaddingBuffer[i] != '\0') \
-                return istreamSetFailure( \
-                    is, \
-                    [luIndex, sectionIndex]() { \
-                        return E::InvalidZeroPaddingException( \
-                            concat("Non-zero padding found after linking " \
-                                   "unit ", luIndex, ", section ", \
-                                   sectionIndex, '!')); \
-                    }); \
-    } while (false)
-#define CHECK_DUPLICATE_SECTION(sName,eName,edesc) \
-    if (lu.sName ## Section) { \
-        return istreamSetFailure( \
-            is, \
-            [luIndex]() { \
-                return E::Multiple ## eName ## SectionsInLinkingUnitException( \
-                    concat("Multiple " edesc " sections defined in " \
-                           "linking unit ", luIndex, '!')); \
-            }); \
-    } else (void) 0
-#define INIT_DATASECTION(sName,eName,edesc) \
-    do { \
-        CHECK_DUPLICATE_SECTION(sName, eName, edesc); \
-        auto newSection(std::make_shared<E::DataSection>()); \
-        if (sectionSize <= 0u) \
-            break; \
-        newSection->data = \
-                std::shared_ptr<void>(::operator new(sectionSize), \
-                                      GlobalDeleter()); \
-        newSection->sizeInBytes = sectionSize; \
-        if (!istreamReadRawData( \
-                is, \
-                newSection->data.get(), \
-                sectionSize, \
-                [luIndex]() { \
-                    return E::FailedToRead ## eName ## SectionDataException( \
-                        concat("Failed to read contents of " edesc \
-                               " section in linking unit ", luIndex, '!'));\
-                })) \
-            return is; \
-        lu.sName ## Section = std::move(newSection); \
-        READ_AND_CHECK_ZERO_PADDING; \
-    } while(false)
-#define INIT_BINDSECTION(sName,eName,edesc) \
-    do { \
-        CHECK_DUPLICATE_SECTION(sName, eName, edesc); \
-        if (sectionSize <= 0) \
-            break; \
-        std::unordered_set<std::string> bsSet; \
-        LimitedBufferFilter limitedBuffer(is, sectionSize); \
-        std::istream is2(&limitedBuffer); \
-        std::string bindName; \
-        auto newSection(std::make_shared<E::eName ## ingsSection>()); \
-        std::vector<std::string> & bs = newSection->sName; \
-        while (std::getline(is2, bindName, '\0')) { \
-            if (bindName.empty()) \
-                return istreamSetFailure( \
-                    is, \
-                    [luIndex, sectionIndex]() { \
-                        return E::Empty ## eName ## ingException( \
-                            concat("Invalid empty binding found in " edesc \
-                                   " section in linking unit ", luIndex, \
-                                   ", section ", sectionIndex, '!')); \
-                    }); \
-            if (bsSet.find(bindName) != bsSet.cend()) \
-                return istreamSetFailure( \
-                    is, \
-                    [luIndex, sectionIndex, &bindName]() { \
-                        return E::Duplicate ## eName ## ingException( \
-                            concat("Duplicate binding for \"", bindName, \
-                                   "\" found in " edesc " section in linking " \
-                                   "unit ", luIndex, ", section ", \
-                                   sectionIndex, '!')); \
-                    }); \
-            bs.emplace_back(bindName); \
-            bsSet.emplace(std::move(bindName)); \
-        } \
-        lu.sName ## Section = std::move(newSection); \
-        READ_AND_CHECK_ZERO_PADDING; \
-    } while(false)
-
-            switch (sectionType) {
-            case ExecutableSectionHeader0x0::SectionType::Text:
-                CHECK_DUPLICATE_SECTION(text, Text, "text");
-
-                lu.textSection = std::make_shared<E::TextSection>();
-                if (sectionSize <= 0u)
-                    break;
-                {
-                    auto & instructions = lu.textSection->instructions;
-                    checkValidNumberOfInstructions(sectionSize);
-                    instructions.reserve(
-                                static_cast<std::size_t>(sectionSize) + 1u);
-                    instructions.resize(sectionSize);
-                    if (!istreamReadRawData(
-                            is,
-                            instructions.data(),
-                            sectionSize * sizeof(SharemindCodeBlock),
-                            [luIndex]() {
-                                return E::FailedToReadTextSectionDataException(
-                                    concat("Failed to read contents of "
-                                           "text section in linking unit ",
-                                           luIndex, '!'));
-                            }))
-                        return is;
-                }
-                break;
-            case ExecutableSectionHeader0x0::SectionType::RoData:
-                INIT_DATASECTION(roData, RoData, "read-only data");
-                break;
-            case ExecutableSectionHeader0x0::SectionType::Data:
-                INIT_DATASECTION(rwData, RwData, "read-write data");
-                break;
-            case ExecutableSectionHeader0x0::SectionType::Bss:
-                CHECK_DUPLICATE_SECTION(bss, Bss, "BSS");
-                lu.bssSection = std::make_shared<E::BssSection>(sectionSize);
-                break;
-            case ExecutableSectionHeader0x0::SectionType::Bind:
-                INIT_BINDSECTION(syscallBindings,
-                                 SyscallBind,
-                                 "system call bindings");
-                break;
-            case ExecutableSectionHeader0x0::SectionType::PdBind:
-                INIT_BINDSECTION(pdBindings,
-                                 PdBind,
-                                 "protection domain bindings");
-                break;
-            default:
-                assert(sectionType ==
-                       ExecutableSectionHeader0x0::SectionType::Debug);
-                INIT_DATASECTION(debug, Debug, "debug");
-                break;
-            }
-            if (!sectionsLeftMinusOne)
-                break;
-        } // Loop over sections in linking unit
-
-        if (!lusLeftMinusOne)
-            break;
-    } // Loop over linking units
-
-    return is;
+    return istreamDeserializeIncrementally(is, ex, exeHeader);
 }
@@ -20,15 +20,29 @@
 #ifndef SHAREMIND_LIBEXECUTABLE_EXECUTABLE_H
 #define SHAREMIND_LIBEXECUTABLE_EXECUTABLE_H
 
+#include <algorithm>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <iosfwd>
 #include <sharemind/Exception.h>
 #include <sharemind/ExceptionMacros.h>
 #include <sharemind/codeblock.h>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
+#include "LargePageAllocator.h"
+#include "libexecutable.h"
+#include "libexecutable_0x0.h"
+#include "libexecutable_0x1.h"
 
 
 namespace sharemind {
@@ -78,6 +92,18 @@ struct Executable {
     SHAREMIND_DECLARE_EXCEPTION_CONST_MSG_NOINLINE(
             NotSerializableException,
             DebugSectionTooBigException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_MSG_NOINLINE(
+            NotSerializableException,
+            InvalidCompressionBlockSizeException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_MSG_NOINLINE(
+            NotSerializableException,
+            InvalidPayloadAlignmentException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            NotSerializableException,
+            FailedToCompressSectionException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            Exception,
+            FailedToWriteException);
     SHAREMIND_DECLARE_EXCEPTION_NOINLINE(Exception,
                                          DeserializationException);
     SHAREMIND_DECLARE_EXCEPTION_CONST_MSG_NOINLINE(
@@ -86,12 +112,18 @@ struct Executable {
     SHAREMIND_DECLARE_EXCEPTION_CONST_MSG_NOINLINE(
             DeserializationException,
             FailedToDeserializeFileHeader0x0Exception);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_MSG_NOINLINE(
+            DeserializationException,
+            FailedToDeserializeFileHeader0x1Exception);
     SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
             DeserializationException,
             FailedToDeserializeLinkingUnitHeader0x0Exception);
     SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
             DeserializationException,
             FailedToDeserializeSectionHeader0x0Exception);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            DeserializationException,
+            FailedToDeserializeSectionHeader0x1Exception);
     SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
             DeserializationException,
             MultipleTextSectionsInLinkingUnitException);
@@ -137,6 +169,15 @@ struct Executable {
     SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
             DeserializationException,
             InvalidZeroPaddingException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            DeserializationException,
+            FailedToDecompressSectionException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            DeserializationException,
+            SectionTooBigException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            DeserializationException,
+            ChecksumMismatchException);
     SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
             DeserializationException,
             DuplicateSyscallBindingException);
@@ -149,6 +190,45 @@ struct Executable {
     SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
             DeserializationException,
             EmptyPdBindingException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            DeserializationException,
+            FailedToOpenFileException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            DeserializationException,
+            FailedToMapFileException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_STDSTRING_NOINLINE(
+            DeserializationException,
+            FailedToReadFileException);
+
+    /*
+      The allocator of an executable. All sections created by deserializing
+      into an executable, or by copying with an explicit allocator, are
+      allocated from its memory resource, including the shared pointer
+      control blocks and the contents of the sections. The default memory
+      resource std::pmr::new_delete_resource() uses the large page backed
+      storage of LargePageAllocator for large sections instead.
+    */
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    /*
+      Selects the constructors of Executable and Executable::LinkingUnit
+      which share the section objects of the copied object instead of
+      copying them. Use unshareSection() before modifying a shared section.
+    */
+    enum ShareSectionsTag { ShareSections };
+
+    /*
+      Selects how deserializeFromFile() and deserializeFromFileAsync() load
+      the file. Map maps the file privately into memory and makes the
+      read-only data and debug sections point into the mapping. Since such a
+      mapping reflects later changes to the file until its pages are copied,
+      the file must then only ever be replaced by renaming a new file over it
+      and never be modified in place. In particular, truncating it, e.g. by
+      copying a new version over it with cp(1), makes accessing these
+      sections raise SIGBUS. Copy reads the file into memory instead, after
+      which the executable does not refer to the file at all.
+    */
+    enum class FileLoadMode { Map, Copy };
 
     struct BssSection {
 
@@ -186,11 +266,22 @@ struct Executable {
         DataSection(void const * dataPtr,
                     std::size_t dataSize,
                     CopyDataTag const);
+        DataSection(void const * dataPtr,
+                    std::size_t dataSize,
+                    CopyDataTag const,
+                    allocator_type const & allocator);
 
         DataSection(DataSection &&) noexcept;
         DataSection(DataSection const &);
+        DataSection(DataSection const & copy,
+                    allocator_type const & allocator);
 
         DataSection & operator=(DataSection &&) noexcept;
+
+        /*
+          Copies the data into storage from the memory resource the current
+          data of this section was allocated from, if any:
+        */
         DataSection & operator=(DataSection const &);
 
     /* Fields: */
@@ -204,19 +295,33 @@ struct Executable {
 
     /* Types: */
 
-        using Container = std::vector<SharemindCodeBlock>;
+        /*
+          Like std::vector<SharemindCodeBlock>, except that large containers
+          are backed as selected by setLargePageMode(). New instructions are
+          value-initialized as usual, see makeDefaultInitializedVector() for
+          avoiding that.
+        */
+        using Container =
+                std::vector<SharemindCodeBlock,
+                            LargePageAllocator<SharemindCodeBlock> >;
 
     /* Methods: */
 
         TextSection()
                 noexcept(
                     std::is_nothrow_default_constructible<Container>::value);
+        explicit TextSection(allocator_type const & allocator) noexcept;
         TextSection(TextSection &&)
                 noexcept(std::is_nothrow_move_constructible<Container>::value);
         TextSection(TextSection const &);
+        TextSection(TextSection const & copy,
+                    allocator_type const & allocator);
         TextSection(Container instructions_)
                 noexcept(std::is_nothrow_move_constructible<Container>::value);
 
+        /* Copies the given instructions: */
+        TextSection(std::vector<SharemindCodeBlock> const & instructions_);
+
         TextSection & operator=(TextSection &&)
                 noexcept(std::is_nothrow_move_assignable<Container>::value);
         TextSection & operator=(TextSection const &);
@@ -227,20 +332,219 @@ struct Executable {
 
     };
 
+    class BindingsTable {
+
+    public: /* Types: */
+
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+        using value_type = std::string_view;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::string_view;
+        using const_reference = std::string_view;
+
+        class const_iterator {
+
+            friend class BindingsTable;
+
+        public: /* Types: */
+
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::string_view;
+
+        public: /* Methods: */
+
+            const_iterator() noexcept = default;
+
+            std::string_view operator*() const noexcept
+            { return (*m_table)[m_index]; }
+
+            std::string_view operator[](difference_type n) const noexcept
+            { return *(*this + n); }
+
+            const_iterator & operator++() noexcept { ++m_index; return *this; }
+            const_iterator & operator--() noexcept { --m_index; return *this; }
+
+            const_iterator operator++(int) noexcept
+            { auto r(*this); ++m_index; return r; }
+
+            const_iterator operator--(int) noexcept
+            { auto r(*this); --m_index; return r; }
+
+            const_iterator & operator+=(difference_type n) noexcept
+            { m_index = static_cast<size_type>(
+                            static_cast<difference_type>(m_index) + n);
+              return *this; }
+
+            const_iterator & operator-=(difference_type n) noexcept
+            { return *this += -n; }
+
+            const_iterator operator+(difference_type n) const noexcept
+            { auto r(*this); return r += n; }
+
+            const_iterator operator-(difference_type n) const noexcept
+            { auto r(*this); return r -= n; }
+
+            difference_type operator-(const_iterator const & rhs)
+                    const noexcept
+            { return static_cast<difference_type>(m_index)
+                     - static_cast<difference_type>(rhs.m_index); }
+
+            bool operator==(const_iterator const & rhs) const noexcept
+            { return m_index == rhs.m_index; }
+
+            bool operator!=(const_iterator const & rhs) const noexcept
+            { return m_index != rhs.m_index; }
+
+            bool operator<(const_iterator const & rhs) const noexcept
+            { return m_index < rhs.m_index; }
+
+            bool operator>(const_iterator const & rhs) const noexcept
+            { return m_index > rhs.m_index; }
+
+            bool operator<=(const_iterator const & rhs) const noexcept
+            { return m_index <= rhs.m_index; }
+
+            bool operator>=(const_iterator const & rhs) const noexcept
+            { return m_index >= rhs.m_index; }
+
+        private: /* Methods: */
+
+            const_iterator(BindingsTable const & table, size_type index)
+                    noexcept
+                : m_table(&table)
+                , m_index(index)
+            {}
+
+        private: /* Fields: */
+
+            BindingsTable const * m_table = nullptr;
+            size_type m_index = 0u;
+
+        };
+
+        using iterator = const_iterator;
+
+    public: /* Constants: */
+
+        static constexpr size_type const npos = static_cast<size_type>(-1);
+
+    public: /* Methods: */
+
+        BindingsTable() noexcept;
+        explicit BindingsTable(allocator_type const & allocator) noexcept;
+        BindingsTable(BindingsTable &&) noexcept;
+        BindingsTable(BindingsTable const &);
+        BindingsTable(BindingsTable const & copy,
+                      allocator_type const & allocator);
+        BindingsTable(std::initializer_list<std::string_view> bindings);
+
+        template <typename InputIterator>
+        BindingsTable(InputIterator first, InputIterator last) {
+            for (; first != last; ++first)
+                push_back(*first);
+        }
+
+        BindingsTable & operator=(BindingsTable &&);
+        BindingsTable & operator=(BindingsTable const &);
+
+        allocator_type get_allocator() const noexcept
+        { return m_data.get_allocator(); }
+
+        bool empty() const noexcept { return m_offsets.empty(); }
+        size_type size() const noexcept { return m_offsets.size(); }
+
+        std::string_view operator[](size_type index) const noexcept {
+            assert(index < m_offsets.size());
+            auto const offset = m_offsets[index];
+            auto const end = (index + 1u < m_offsets.size())
+                             ? m_offsets[index + 1u]
+                             : m_data.size();
+            return std::string_view(m_data.data() + offset, end - offset - 1u);
+        }
+
+        std::string_view front() const noexcept { return (*this)[0u]; }
+        std::string_view back() const noexcept
+        { return (*this)[m_offsets.size() - 1u]; }
+
+        const_iterator begin() const noexcept { return {*this, 0u}; }
+        const_iterator cbegin() const noexcept { return {*this, 0u}; }
+        const_iterator end() const noexcept { return {*this, size()}; }
+        const_iterator cend() const noexcept { return {*this, size()}; }
+
+        void reserve(size_type numBindings, size_type sizeInBytes);
+
+        void push_back(std::string_view binding);
+
+        /* Appends the binding unless it is already present in the table: */
+        bool insert(std::string_view binding);
+
+        template <typename ... Args>
+        void emplace_back(Args && ... args)
+        { push_back(std::string_view(std::forward<Args>(args)...)); }
+
+        void clear() noexcept;
+
+        /*
+          Returns the index of the first occurrence of the given binding, or
+          npos if the table contains no such binding.
+        */
+        size_type find(std::string_view binding) const noexcept;
+
+        bool contains(std::string_view binding) const noexcept
+        { return find(binding) != npos; }
+
+        /*
+          The bindings as NUL-terminated strings stored back to back, i.e. in
+          the same form as in the payload of a serialized bindings section.
+        */
+        char const * data() const noexcept { return m_data.data(); }
+        size_type sizeInBytes() const noexcept { return m_data.size(); }
+
+    private: /* Methods: */
+
+        bool append(std::string_view binding, bool appendDuplicate);
+        size_type findSlot(std::string_view binding, std::size_t hash)
+                const noexcept;
+        void rehash(size_type numSlots);
+
+    private: /* Fields: */
+
+        std::pmr::string m_data;
+        std::pmr::vector<size_type> m_offsets;
+
+        /*
+          Open addressing hash index over the first occurrences of all
+          bindings. Each slot holds a binding index plus one, or zero if the
+          slot is empty. The hashes of all bindings are kept for rehashing.
+        */
+        std::pmr::vector<std::size_t> m_hashes;
+        std::pmr::vector<size_type> m_slots;
+        size_type m_numIndexed = 0u;
+
+    };
+
     struct SyscallBindingsSection {
 
     /* Types: */
 
-        using Container = std::vector<std::string>;
+        using Container = BindingsTable;
 
     /* Methods: */
 
         SyscallBindingsSection()
                 noexcept(
                     std::is_nothrow_default_constructible<Container>::value);
+        explicit SyscallBindingsSection(allocator_type const & allocator)
+                noexcept;
         SyscallBindingsSection(SyscallBindingsSection &&)
                 noexcept(std::is_nothrow_move_constructible<Container>::value);
         SyscallBindingsSection(SyscallBindingsSection const &);
+        SyscallBindingsSection(SyscallBindingsSection const & copy,
+                               allocator_type const & allocator);
         SyscallBindingsSection(Container bindings)
                 noexcept(std::is_nothrow_move_constructible<Container>::value);
 
@@ -258,16 +562,19 @@ struct Executable {
 
     /* Types: */
 
-        using Container = std::vector<std::string>;
+        using Container = BindingsTable;
 
     /* Methods: */
 
         PdBindingsSection()
                 noexcept(
                     std::is_nothrow_default_constructible<Container>::value);
+        explicit PdBindingsSection(allocator_type const & allocator) noexcept;
         PdBindingsSection(PdBindingsSection &&)
                 noexcept(std::is_nothrow_move_constructible<Container>::value);
         PdBindingsSection(PdBindingsSection const &);
+        PdBindingsSection(PdBindingsSection const & copy,
+                          allocator_type const & allocator);
         PdBindingsSection(Container pdBindings_)
                 noexcept(std::is_nothrow_move_constructible<Container>::value);
 
@@ -288,12 +595,30 @@ struct Executable {
         LinkingUnit() noexcept;
         LinkingUnit(LinkingUnit &&) noexcept;
         LinkingUnit(LinkingUnit const &);
+        LinkingUnit(LinkingUnit const & copy, ShareSectionsTag const) noexcept;
+
+        /* Copies all sections using the given allocator: */
+        LinkingUnit(LinkingUnit const & copy,
+                    allocator_type const & allocator);
 
         LinkingUnit & operator=(LinkingUnit &&) noexcept;
         LinkingUnit & operator=(LinkingUnit const &);
 
         std::size_t numberOfSections() const noexcept;
 
+        /*
+          Replaces the given section with a private copy if it is shared with
+          any other owner, and returns a reference to the section.
+        */
+        template <typename Section>
+        static Section & unshareSection(std::shared_ptr<Section> & section) {
+            assert(section);
+            if (section.use_count() > 1)
+                section = std::make_shared<Section>(
+                              static_cast<Section const &>(*section));
+            return *section;
+        }
+
     /* Fields: */
 
         std::shared_ptr<TextSection> textSection;
@@ -306,20 +631,357 @@ struct Executable {
 
     };
 
-    using LuContainer = std::vector<LinkingUnit>;
+    using LuContainer = std::pmr::vector<LinkingUnit>;
+
+    /* Runs the given task, possibly asynchronously on another thread: */
+    using Executor = std::function<void (std::function<void ()>)>;
+
+    struct TableOfContents {
+
+    /* Types: */
+
+        using SectionType = ExecutableSectionHeader0x0::SectionType;
+        using Compression = ExecutableSectionHeader0x1::Compression;
+
+        struct Section {
+
+        /* Fields: */
+
+            SectionType type = SectionType::Invalid;
+
+            /* The size as given in the section header: */
+            std::size_t size = 0u;
+
+            std::size_t headerOffset = 0u;
+            std::size_t dataOffset = 0u;
+
+            /* The size of the contents of the section in bytes: */
+            std::size_t dataSizeInBytes = 0u;
+
+            /*
+              How the contents are stored at dataOffset. The number of bytes
+              stored there equals dataSizeInBytes unless compressed:
+            */
+            Compression compression = Compression::None;
+            std::size_t blockSize = 0u;
+            std::size_t storedSizeInBytes = 0u;
+
+            /* The CRC-32C of the stored bytes, if present: */
+            bool hasChecksum = false;
+            std::uint32_t checksum = 0u;
+
+        };
+
+        struct LinkingUnit {
+
+        /* Fields: */
+
+            std::size_t headerOffset = 0u;
+            std::vector<Section> sections;
+
+        };
+
+    /* Methods: */
+
+        /*
+          Walks all headers of the given serialized executable, checking that
+          all payloads and their zero padding are within bounds. Throws the
+          same exceptions as Executable::deserializeFrom(), except for those
+          related to the contents of the sections.
+        */
+        void scan(void const * data, std::size_t size);
+
+        /*
+          Walks all headers of the serialized executable read from the given
+          stream, seeking past section payloads when the stream supports it,
+          so that only the headers, zero padding and the last byte of each
+          payload are read. Offsets are relative to the initial position of
+          the stream. Throws the same exceptions as scan(data, size),
+          regardless of the exception mask of the stream.
+        */
+        void scan(std::istream & is);
+
+        /*
+          Deserializes the given section of the given linking unit from the
+          executable image this table of contents was scanned from into the
+          respective section of lu, allocating the section with the given
+          allocator. If dataOwner is set, data sections point into the image
+          instead of copying their contents. The checksum of the section, if
+          present, is verified while reading its contents.
+        */
+        void materializeSection(
+                Executable::LinkingUnit & lu,
+                std::size_t luIndex,
+                std::size_t sectionIndex,
+                void const * data,
+                std::shared_ptr<void> const & dataOwner,
+                allocator_type const & allocator = allocator_type()) const;
+
+    /* Fields: */
+
+        std::size_t fileFormatVersion = 0x0;
+        std::size_t activeLinkingUnitIndex = 0u;
+
+        /*
+          The alignment of all non-empty section payloads relative to the
+          start of the executable:
+        */
+        std::size_t payloadAlignment = 8u;
+
+        std::size_t sizeInBytes = 0u;
+        std::vector<LinkingUnit> linkingUnits;
+
+    };
+
+    struct SerializationOptions {
+
+    /* Fields: */
+
+        std::size_t fileFormatVersion = 0x0;
+
+        /*
+          Compression requires file format version 0x1 or later. Sections
+          are compressed in independent blocks of compressionBlockSize bytes
+          so that they can be decompressed in parallel. Sections which do not
+          get smaller are stored uncompressed.
+        */
+        ExecutableSectionHeader0x1::Compression compression =
+                ExecutableSectionHeader0x1::Compression::None;
+        int compressionLevel = 3;
+        std::size_t compressionBlockSize = 1024u * 1024u;
+
+        /*
+          Whether to store the CRC-32C of the contents of every section. This
+          requires file format version 0x1 or later.
+        */
+        bool checksums = false;
+
+        /*
+          The alignment of all non-empty section payloads relative to the
+          start of the executable. This must be a power of two between 8 bytes
+          and 2 MiB. Alignments above 8 bytes require file format version 0x1
+          or later. Aligning payloads to the page size allows data sections to
+          be used in place when the executable is mapped into memory.
+        */
+        std::size_t payloadAlignment = 8u;
+
+    };
+
+    /*
+      The exact layout of a serialized executable. Constructing a plan checks
+      that the executable is serializable and computes the offsets of all
+      headers, sections and padding, and the total size of the result. The
+      plan refers to the contents of the executable and remains valid and
+      reusable for as long as the executable is not modified.
+    */
+    class SerializationPlan {
+
+    public: /* Types: */
+
+        struct Chunk {
+
+        /* Fields: */
+
+            void const * data;
+            std::size_t size;
+
+        };
+
+    public: /* Methods: */
+
+        explicit SerializationPlan(Executable const & executable);
+        SerializationPlan(Executable const & executable,
+                          SerializationOptions const & options);
+
+        /* Like the above, but compresses blocks concurrently: */
+        SerializationPlan(Executable const & executable,
+                          SerializationOptions const & options,
+                          Executor const & executor);
+
+        SerializationPlan(SerializationPlan &&) noexcept;
+        SerializationPlan(SerializationPlan const &);
+
+        SerializationPlan & operator=(SerializationPlan &&) noexcept;
+        SerializationPlan & operator=(SerializationPlan const &);
+
+        ~SerializationPlan() noexcept;
+
+        std::size_t sizeInBytes() const noexcept
+        { return m_tableOfContents.sizeInBytes; }
+
+        /*
+          The layout of the result. The padding after a section starts at its
+          dataOffset + storedSizeInBytes and ends where the next header
+          starts.
+        */
+        TableOfContents const & tableOfContents() const noexcept
+        { return m_tableOfContents; }
+
+        /*
+          The consecutive non-empty pieces of memory making up the result.
+          These refer to the executable, to headers and compressed contents
+          stored in the plan and to static zero padding.
+        */
+        std::vector<Chunk> const & chunks() const noexcept
+        { return m_chunks; }
+
+        /*
+          Copies the result into the given buffer if it is at least
+          sizeInBytes() bytes long, otherwise leaves the buffer untouched.
+          Returns sizeInBytes() in both cases.
+        */
+        std::size_t writeTo(void * buffer, std::size_t size) const noexcept;
+        void writeTo(int fd) const;
+        std::ostream & writeTo(std::ostream & os) const;
+
+    private: /* Methods: */
+
+        SerializationPlan(Executable const & executable,
+                          SerializationOptions const & options,
+                          Executor const * executor);
+
+    private: /* Fields: */
+
+        std::vector<char> m_headers;
+        std::vector<std::shared_ptr<std::vector<char> const> > m_buffers;
+        std::vector<Chunk> m_chunks;
+        TableOfContents m_tableOfContents;
+
+    };
+
+    /*
+      A push-based parser which deserializes an executable from consecutive
+      chunks of input as they become available. Section contents are copied
+      directly into the sections of the resulting executable. Since the sizes
+      in the headers are not trusted, the storage of large sections is grown
+      as their contents arrive instead of being allocated up front. If feed()
+      throws, the parser must be reset() before it can be used again.
+    */
+    class IncrementalParser;
 
 /* Methods: */
 
     Executable()
             noexcept(std::is_nothrow_default_constructible<LuContainer>::value);
+    explicit Executable(allocator_type const & allocator) noexcept;
     Executable(Executable &&)
             noexcept(std::is_nothrow_move_constructible<LuContainer>::value);
     Executable(Executable const &);
+    Executable(Executable const & copy, ShareSectionsTag const);
+
+    /* Copies all sections using the given allocator: */
+    Executable(Executable const & copy, allocator_type const & allocator);
 
+    /*
+      If the allocators of the executables differ, move assignment moves the
+      linking units into storage allocated with the allocator of this
+      executable. The linking units keep referring to their sections.
+    */
     Executable & operator=(Executable &&)
             noexcept(std::is_nothrow_move_assignable<LuContainer>::value);
     Executable & operator=(Executable const &);
 
+    allocator_type get_allocator() const noexcept
+    { return linkingUnits.get_allocator(); }
+
+    /*
+      Deserializes the executable from the given contiguous buffer of the
+      given size. The first overload copies all section data, whereas the
+      second makes the read-only data and debug sections of the result share
+      ownership of the given buffer and point into it. Read-write data
+      sections are always copied, so that modifying them never affects the
+      buffer and vice versa.
+    */
+    void deserializeFrom(void const * data, std::size_t size);
+    void deserializeFrom(std::shared_ptr<void> data, std::size_t size);
+
+    /*
+      Like the above, but after scanning the headers, decodes all sections
+      concurrently as separate tasks run by the given executor. Waits until
+      all tasks have finished. If several sections fail to decode, throws
+      the exception of the first such section in file order. The memory
+      resource of the executable must be safe for concurrent use, e.g. a
+      std::pmr::synchronized_pool_resource.
+    */
+    void deserializeFrom(void const * data,
+                         std::size_t size,
+                         Executor const & executor);
+    void deserializeFrom(std::shared_ptr<void> data,
+                         std::size_t size,
+                         Executor const & executor);
+
+    /*
+      Deserializes the executable from the given file as selected by mode. By
+      default, the file is mapped privately into memory, and the data of the
+      read-only data and debug sections of the result point directly into the
+      mapping, which is kept alive for as long as any of these sections refer
+      to it. See FileLoadMode for the resulting restrictions on modifying the
+      file.
+    */
+    void deserializeFromFile(char const * filename,
+                             FileLoadMode mode = FileLoadMode::Map);
+    void deserializeFromFile(std::string const & filename,
+                             FileLoadMode mode = FileLoadMode::Map)
+    { return deserializeFromFile(filename.c_str(), mode); }
+    void deserializeFromFile(char const * filename,
+                             Executor const & executor,
+                             FileLoadMode mode = FileLoadMode::Map);
+    void deserializeFromFile(std::string const & filename,
+                             Executor const & executor,
+                             FileLoadMode mode = FileLoadMode::Map)
+    { return deserializeFromFile(filename.c_str(), executor, mode); }
+
+    /*
+      Deserializes the executable from the given open file descriptor of a
+      regular file, as selected by mode, like deserializeFromFile(). The whole
+      file is read regardless of the file offset of the descriptor, which is
+      neither changed nor closed. The given file name is only used in error
+      messages.
+    */
+    void deserializeFromFileDescriptor(int fd,
+                                       char const * filename,
+                                       FileLoadMode mode = FileLoadMode::Map);
+
+    /*
+      Deserializes the executable from the given file in the background and
+      returns a future for the result. Before returning, the file is opened
+      and the kernel is asked to start reading it ahead, so that the I/O of
+      many files loaded this way proceeds concurrently. The first overload
+      deserializes on a new thread, the second as a task run by the given
+      executor. Errors, including failure to open the file, are reported
+      through the returned future. The file is loaded as selected by mode.
+    */
+    static std::future<Executable> deserializeFromFileAsync(
+            std::string filename,
+            FileLoadMode mode = FileLoadMode::Map);
+    static std::future<Executable> deserializeFromFileAsync(
+            std::string filename,
+            Executor const & executor,
+            FileLoadMode mode = FileLoadMode::Map);
+
+    /*
+      Maps the given file privately into memory and sets size to the size of
+      the file. Returns an empty pointer for empty files. The same
+      restrictions on modifying the file apply as for FileLoadMode::Map.
+    */
+    static std::shared_ptr<void> mapFile(char const * filename,
+                                         std::size_t & size);
+
+    /*
+      Serializes the executable to the given file descriptor with as few
+      writev() calls as possible, writing headers, section contents and
+      padding directly from memory without intermediate copies.
+    */
+    void serializeToFileDescriptor(int fd) const;
+
+    /*
+      Serializes the executable into the given buffer. Returns the number of
+      bytes the serialized executable takes. If this is greater than size, the
+      buffer is left untouched and the call should be repeated with a buffer
+      of at least the returned size.
+    */
+    std::size_t serializeTo(void * buffer, std::size_t size) const;
+
 /* Fields: */
 
     std::size_t fileFormatVersion = 0x0;
@@ -328,6 +990,131 @@ struct Executable {
 
 };
 
+class Executable::IncrementalParser {
+
+public: /* Types: */
+
+    enum class Status { NeedMoreData, Done };
+
+public: /* Methods: */
+
+    IncrementalParser();
+
+    /* Deserializes into executables using the given allocator: */
+    explicit IncrementalParser(allocator_type const & allocator);
+
+    IncrementalParser(IncrementalParser &&) noexcept;
+    IncrementalParser(IncrementalParser const &) = delete;
+
+    IncrementalParser & operator=(IncrementalParser &&);
+    IncrementalParser & operator=(IncrementalParser const &) = delete;
+
+    ~IncrementalParser() noexcept;
+
+    /*
+      Consumes the given chunk of input. Once the end of the executable
+      is reached, returns Status::Done and leaves any remaining input
+      unconsumed, see bytesConsumed().
+    */
+    Status feed(void const * data, std::size_t size);
+
+    Status status() const noexcept;
+
+    /* The total number of input bytes consumed so far: */
+    std::size_t bytesConsumed() const noexcept { return m_consumed; }
+
+    /*
+      The number of bytes needed to complete the header, section contents
+      or padding currently being read. More input may be needed after
+      that.
+    */
+    std::size_t bytesNeeded() const noexcept
+    { return m_itemSize - m_itemFill; }
+
+    /*
+      Throws the respective deserialization exception if the end of the
+      executable has not yet been reached, e.g. when the input ended
+      prematurely.
+    */
+    void finish() const;
+
+    /*
+      The executable being deserialized. It is incomplete until feed()
+      returns Status::Done, after which it may be moved from.
+    */
+    Executable & executable() noexcept { return m_executable; }
+    Executable const & executable() const noexcept
+    { return m_executable; }
+
+    /* The layout of the input consumed so far: */
+    TableOfContents const & tableOfContents() const noexcept
+    { return m_tableOfContents; }
+
+    /* Prepares the parser for deserializing another executable: */
+    void reset() noexcept;
+
+private: /* Types: */
+
+    enum class State {
+        CommonHeader,
+        FileHeader,
+        LinkingUnitHeader,
+        SectionHeader,
+        AlignmentPadding,
+        SectionData,
+        Padding,
+        Done
+    };
+
+private: /* Methods: */
+
+    void takeItemState(IncrementalParser & move) noexcept;
+    void startItem(State state, void * dest, std::size_t size) noexcept;
+    void growItem();
+    void startLinkingUnit();
+    void startSection();
+    void completeItem();
+    void completeCommonHeader();
+    void completeFileHeader();
+    void completeLinkingUnitHeader();
+    void completeSectionHeader();
+    void completeAlignmentPadding();
+    void startSectionData();
+    void completeSectionData();
+    void completePadding();
+
+private: /* Fields: */
+
+    Executable m_executable;
+    TableOfContents m_tableOfContents;
+
+    State m_state;
+    char * m_itemDest;
+    std::size_t m_itemSize;
+    std::size_t m_itemCapacity;
+    std::size_t m_itemFill;
+    std::size_t m_consumed;
+
+    std::size_t m_numLinkingUnits;
+    std::size_t m_numSections;
+    bool m_haveSection[
+            static_cast<std::size_t>(
+                ExecutableSectionHeader0x0::SectionType::Count)];
+    /* Bindings and compressed contents are decoded once read completely: */
+    std::vector<char> m_payload;
+    /* The checksum of the section contents read so far, if needed: */
+    bool m_checksumItem;
+    std::uint32_t m_checksum;
+
+    char m_buffer[std::max({sizeof(ExecutableCommonHeader),
+                            sizeof(ExecutableHeader0x0),
+                            sizeof(ExecutableHeader0x1),
+                            sizeof(ExecutableLinkingUnitHeader0x0),
+                            sizeof(ExecutableSectionHeader0x0),
+                            sizeof(ExecutableSectionHeader0x1)})];
+
+};
+
 } /* namespace sharemind { */
 
 std::ostream & operator<<(std::ostream & os, sharemind::Executable const & ex);
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#include "ExecutableCache.h"
+
+#include <cassert>
+#include <cerrno>
+#include <fcntl.h>
+#include <sharemind/Concat.h>
+#include <sharemind/ThrowNested.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <tuple>
+#include <unistd.h>
+#include <utility>
+
+
+namespace sharemind {
+namespace {
+
+class FileDescriptorGuard {
+
+public: /* Methods: */
+
+    FileDescriptorGuard(FileDescriptorGuard &&) = delete;
+    FileDescriptorGuard(FileDescriptorGuard const &) = delete;
+
+    FileDescriptorGuard(int fd) noexcept : m_fd(fd) {}
+    ~FileDescriptorGuard() noexcept { ::close(m_fd); }
+
+private: /* Fields: */
+
+    int const m_fd;
+
+};
+
+} // anonymous namespace
+
+bool ExecutableCache::FileIdentity::operator<(FileIdentity const & rhs)
+        const noexcept
+{
+    return std::tie(device,
+                    inode,
+                    modificationTimeSeconds,
+                    modificationTimeNanoseconds,
+                    size)
+           < std::tie(rhs.device,
+                      rhs.inode,
+                      rhs.modificationTimeSeconds,
+                      rhs.modificationTimeNanoseconds,
+                      rhs.size);
+}
+
+bool ExecutableCache::FileIdentity::operator==(FileIdentity const & rhs)
+        const noexcept
+{
+    return device == rhs.device
+           && inode == rhs.inode
+           && modificationTimeSeconds == rhs.modificationTimeSeconds
+           && modificationTimeNanoseconds == rhs.modificationTimeNanoseconds
+           && size == rhs.size;
+}
+
+ExecutableCache::ExecutableCache(std::size_t budgetInBytes,
+                                 Executable::FileLoadMode loadMode) noexcept
+    : m_loadMode(loadMode)
+    , m_budget(budgetInBytes)
+{}
+
+ExecutableCache::~ExecutableCache() noexcept = default;
+
+ExecutableCache::ExecutablePtr ExecutableCache::load(char const * filename) {
+    assert(filename);
+    /* The file is opened only once, so that the identity used as the key is
+       that of the very file the executable is loaded from: */
+    int const fd = ::open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throwNested(std::system_error(errno, std::generic_category()),
+                    Executable::FailedToOpenFileException(
+                        concat("Failed to open file \"", filename, "\"!")));
+    FileDescriptorGuard const fdGuard(fd);
+    auto const identity(fileIdentity(fd, filename));
+
+    {
+        std::lock_guard<std::mutex> const guard(m_mutex);
+        auto const it(m_index.find(identity));
+        if (it != m_index.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return it->second->executable;
+        }
+    }
+
+    auto executable(std::make_shared<Executable>());
+    executable->deserializeFromFileDescriptor(fd, filename, m_loadMode);
+    ExecutablePtr r(std::move(executable));
+
+    /* Do not cache the result if the file was modified while it was being
+       loaded: */
+    if (!(fileIdentity(fd, filename) == identity))
+        return r;
+
+    auto const size = executableSizeInBytes(*r);
+
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    auto const it(m_index.find(identity));
+    if (it != m_index.end()) { // Loaded concurrently by another thread
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return it->second->executable;
+    }
+    if (size > m_budget)
+        return r;
+    m_lru.emplace_front(Entry{identity, r, size});
+    try {
+        m_index.emplace(identity, m_lru.begin());
+    } catch (...) {
+        m_lru.pop_front();
+        throw;
+    }
+    m_sizeInBytes += size;
+    evict();
+    return r;
+}
+
+void ExecutableCache::clear() noexcept {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    m_index.clear();
+    m_lru.clear();
+    m_sizeInBytes = 0u;
+}
+
+std::size_t ExecutableCache::budget() const noexcept {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    return m_budget;
+}
+
+void ExecutableCache::setBudget(std::size_t budgetInBytes) noexcept {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    m_budget = budgetInBytes;
+    evict();
+}
+
+std::size_t ExecutableCache::sizeInBytes() const noexcept {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    return m_sizeInBytes;
+}
+
+std::size_t ExecutableCache::numberOfEntries() const noexcept {
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    return m_lru.size();
+}
+
+std::size_t ExecutableCache::executableSizeInBytes(
+        Executable const & executable) noexcept
+{
+    std::size_t r = 0u;
+    for (auto const & lu : executable.linkingUnits) {
+        if (lu.textSection)
+            r += lu.textSection->instructions.size()
+                 * sizeof(SharemindCodeBlock);
+        if (lu.roDataSection)
+            r += lu.roDataSection->sizeInBytes;
+        if (lu.rwDataSection)
+            r += lu.rwDataSection->sizeInBytes;
+        if (lu.syscallBindingsSection)
+            r += lu.syscallBindingsSection->syscallBindings.sizeInBytes();
+        if (lu.pdBindingsSection)
+            r += lu.pdBindingsSection->pdBindings.sizeInBytes();
+        if (lu.debugSection)
+            r += lu.debugSection->sizeInBytes;
+    }
+    return r;
+}
+
+ExecutableCache::FileIdentity ExecutableCache::fileIdentity(
+        int fd,
+        char const * filename)
+{
+    struct ::stat st;
+    if (::fstat(fd, &st) != 0)
+        throwNested(std::system_error(errno, std::generic_category()),
+                    Executable::FailedToOpenFileException(
+                        concat("Failed to stat file \"", filename, "\"!")));
+    return FileIdentity{static_cast<std::uintmax_t>(st.st_dev),
+                        static_cast<std::uintmax_t>(st.st_ino),
+                        static_cast<std::intmax_t>(st.st_mtim.tv_sec),
+                        static_cast<std::intmax_t>(st.st_mtim.tv_nsec),
+                        static_cast<std::uintmax_t>(st.st_size)};
+}
+
+void ExecutableCache::evict() noexcept {
+    while (m_sizeInBytes > m_budget) {
+        assert(!m_lru.empty());
+        auto const & entry = m_lru.back();
+        m_sizeInBytes -= entry.sizeInBytes;
+        m_index.erase(entry.identity);
+        m_lru.pop_back();
+    }
+}
+
+} // namespace sharemind {
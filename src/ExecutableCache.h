@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#ifndef SHAREMIND_LIBEXECUTABLE_EXECUTABLECACHE_H
+#define SHAREMIND_LIBEXECUTABLE_EXECUTABLECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "Executable.h"
+
+
+namespace sharemind {
+
+/*
+  A cache of executables loaded from files, keyed by the identity of the file
+  (device, inode, modification time and size). Each file is opened once, and
+  both its identity and the executable are read through that descriptor.
+  Executables are handed out as shared instances which must not be modified.
+  When the total size of the sections of the cached executables exceeds the
+  budget, the least recently used executables are evicted from the cache.
+  Evicted executables stay alive for as long as they are referenced
+  elsewhere.
+
+  By default, files are loaded with Executable::FileLoadMode::Copy, so that
+  cached executables do not change even if their files are later modified in
+  place. With Executable::FileLoadMode::Map, the files of cached executables
+  must only be replaced by renaming new files over them, since otherwise
+  executables already handed out observe the changes or even raise SIGBUS.
+*/
+class ExecutableCache {
+
+public: /* Types: */
+
+    using ExecutablePtr = std::shared_ptr<Executable const>;
+
+public: /* Methods: */
+
+    explicit ExecutableCache(
+            std::size_t budgetInBytes,
+            Executable::FileLoadMode loadMode = Executable::FileLoadMode::Copy)
+            noexcept;
+
+    ExecutableCache(ExecutableCache &&) = delete;
+    ExecutableCache(ExecutableCache const &) = delete;
+
+    ExecutableCache & operator=(ExecutableCache &&) = delete;
+    ExecutableCache & operator=(ExecutableCache const &) = delete;
+
+    ~ExecutableCache() noexcept;
+
+    ExecutablePtr load(char const * filename);
+    ExecutablePtr load(std::string const & filename)
+    { return load(filename.c_str()); }
+
+    void clear() noexcept;
+
+    std::size_t budget() const noexcept;
+    void setBudget(std::size_t budgetInBytes) noexcept;
+
+    /*
+      The total size of the sections of all cached executables, as computed
+      by executableSizeInBytes():
+    */
+    std::size_t sizeInBytes() const noexcept;
+
+    std::size_t numberOfEntries() const noexcept;
+
+    /*
+      The total size of the contents of all sections of the given executable,
+      as accounted against the budget of the cache. This is the nominal size
+      of the sections, not their resident memory usage: sections pointing
+      into a file mapping are counted although they occupy shared page cache
+      rather than private memory, and allocation overhead, page rounding and
+      the size of the bindings tables beyond their names are not counted.
+    */
+    static std::size_t executableSizeInBytes(Executable const & executable)
+            noexcept;
+
+private: /* Types: */
+
+    struct FileIdentity {
+
+    /* Methods: */
+
+        bool operator<(FileIdentity const & rhs) const noexcept;
+        bool operator==(FileIdentity const & rhs) const noexcept;
+
+    /* Fields: */
+
+        std::uintmax_t device;
+        std::uintmax_t inode;
+        std::intmax_t modificationTimeSeconds;
+        std::intmax_t modificationTimeNanoseconds;
+        std::uintmax_t size;
+
+    };
+
+    struct Entry {
+
+    /* Fields: */
+
+        FileIdentity identity;
+        ExecutablePtr executable;
+        std::size_t sizeInBytes;
+
+    };
+
+    using LruList = std::list<Entry>;
+
+private: /* Methods: */
+
+    static FileIdentity fileIdentity(int fd, char const * filename);
+
+    void evict() noexcept;
+
+private: /* Fields: */
+
+    Executable::FileLoadMode const m_loadMode;
+    mutable std::mutex m_mutex;
+    std::size_t m_budget;
+    std::size_t m_sizeInBytes = 0u;
+
+    /* Most recently used entries first: */
+    LruList m_lru;
+    std::map<FileIdentity, LruList::iterator> m_index;
+
+};
+
+} /* namespace sharemind { */
+
+#endif /* SHAREMIND_LIBEXECUTABLE_EXECUTABLECACHE_H */
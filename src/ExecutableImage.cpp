@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#include "ExecutableImage.h"
+
+#include <cassert>
+#include <cerrno>
+#include <fcntl.h>
+#include <limits>
+#include <linux/memfd.h>
+#include <new>
+#include <sharemind/IntegralComparisons.h>
+#include <sharemind/ThrowNested.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+
+namespace sharemind {
+
+SHAREMIND_DEFINE_EXCEPTION_NOINLINE(Executable::Exception,
+                                    ExecutableImage::,
+                                    Exception);
+SHAREMIND_DEFINE_EXCEPTION_CONST_MSG_NOINLINE(
+        Exception,
+        ExecutableImage::,
+        FailedToCreateBackingException,
+        "Failed to create the backing of the read-write data section!");
+SHAREMIND_DEFINE_EXCEPTION_CONST_MSG_NOINLINE(
+        Exception,
+        ExecutableImage::,
+        FailedToMapInstanceException,
+        "Failed to map the memory of an executable instance!");
+
+namespace {
+
+std::size_t pageSize() noexcept {
+    static std::size_t const r =
+            []() noexcept {
+                auto const pageSize = ::sysconf(_SC_PAGESIZE);
+                return (pageSize > 0) ? static_cast<std::size_t>(pageSize)
+                                      : 4096u;
+            }();
+    return r;
+}
+
+std::size_t roundUpToPageSize(std::size_t size) {
+    auto const mask = pageSize() - 1u;
+    if (size > std::numeric_limits<std::size_t>::max() - mask)
+        throw std::bad_alloc();
+    return (size + mask) & ~mask;
+}
+
+[[noreturn]] void throwFailedToCreateBacking() {
+    throwNested(std::system_error(errno, std::generic_category()),
+                ExecutableImage::FailedToCreateBackingException());
+}
+
+/*
+  Creates an anonymous in-memory file with the given contents, which is sealed
+  against any further modification if supported. Falls back to an unlinked
+  temporary file on kernels without memfd_create(2):
+*/
+int createBacking(void const * data, std::size_t size) {
+    bool sealable = true;
+    int fd = static_cast<int>(
+                ::syscall(SYS_memfd_create,
+                          "sharemind-executable-rwdata",
+                          MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (fd < 0) {
+        if (errno != ENOSYS)
+            throwFailedToCreateBacking();
+        sealable = false;
+        fd = ::open("/tmp", O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0)
+            throwFailedToCreateBacking();
+    }
+
+    try {
+        if (integralGreater(size, std::numeric_limits<::off_t>::max())
+            || ::ftruncate(fd, static_cast<::off_t>(size)) != 0)
+            throwFailedToCreateBacking();
+
+        auto in = static_cast<char const *>(data);
+        std::size_t offset = 0u;
+        while (offset < size) {
+            auto const r = ::pwrite(fd,
+                                    in + offset,
+                                    size - offset,
+                                    static_cast<::off_t>(offset));
+            if (r < 0) {
+                if (errno == EINTR)
+                    continue;
+                throwFailedToCreateBacking();
+            }
+            offset += static_cast<std::size_t>(r);
+        }
+
+        if (sealable
+            && ::fcntl(fd,
+                       F_ADD_SEALS,
+                       F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE
+                       | F_SEAL_SEAL) != 0)
+            throwFailedToCreateBacking();
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    return fd;
+}
+
+} // anonymous namespace
+
+ExecutableImage::Instance::Instance(Instance && move) noexcept
+    : m_mapping(std::exchange(move.m_mapping, nullptr))
+    , m_mappingSize(std::exchange(move.m_mappingSize, 0u))
+    , m_rwData(std::exchange(move.m_rwData, nullptr))
+    , m_rwDataSizeInBytes(std::exchange(move.m_rwDataSizeInBytes, 0u))
+    , m_bss(std::exchange(move.m_bss, nullptr))
+    , m_bssSizeInBytes(std::exchange(move.m_bssSizeInBytes, 0u))
+{}
+
+ExecutableImage::Instance & ExecutableImage::Instance::operator=(
+        Instance && move) noexcept
+{
+    if (this != &move) {
+        if (m_mapping)
+            ::munmap(m_mapping, m_mappingSize);
+        m_mapping = std::exchange(move.m_mapping, nullptr);
+        m_mappingSize = std::exchange(move.m_mappingSize, 0u);
+        m_rwData = std::exchange(move.m_rwData, nullptr);
+        m_rwDataSizeInBytes = std::exchange(move.m_rwDataSizeInBytes, 0u);
+        m_bss = std::exchange(move.m_bss, nullptr);
+        m_bssSizeInBytes = std::exchange(move.m_bssSizeInBytes, 0u);
+    }
+    return *this;
+}
+
+ExecutableImage::Instance::~Instance() noexcept {
+    if (m_mapping)
+        ::munmap(m_mapping, m_mappingSize);
+}
+
+ExecutableImage::ExecutableImage(Executable::LinkingUnit const & linkingUnit)
+{
+    if (linkingUnit.rwDataSection && linkingUnit.rwDataSection->sizeInBytes) {
+        auto const & rwData = *linkingUnit.rwDataSection;
+        m_rwDataFd = createBacking(rwData.data.get(), rwData.sizeInBytes);
+        m_rwDataSizeInBytes = rwData.sizeInBytes;
+    }
+    if (linkingUnit.bssSection)
+        m_bssSizeInBytes = linkingUnit.bssSection->sizeInBytes;
+}
+
+ExecutableImage::ExecutableImage(Executable const & executable)
+    : ExecutableImage(
+          executable.linkingUnits.at(executable.activeLinkingUnitIndex))
+{}
+
+ExecutableImage::ExecutableImage(ExecutableImage && move) noexcept
+    : m_rwDataFd(std::exchange(move.m_rwDataFd, -1))
+    , m_rwDataSizeInBytes(std::exchange(move.m_rwDataSizeInBytes, 0u))
+    , m_bssSizeInBytes(std::exchange(move.m_bssSizeInBytes, 0u))
+{}
+
+ExecutableImage & ExecutableImage::operator=(ExecutableImage && move) noexcept
+{
+    if (this != &move) {
+        if (m_rwDataFd >= 0)
+            ::close(m_rwDataFd);
+        m_rwDataFd = std::exchange(move.m_rwDataFd, -1);
+        m_rwDataSizeInBytes = std::exchange(move.m_rwDataSizeInBytes, 0u);
+        m_bssSizeInBytes = std::exchange(move.m_bssSizeInBytes, 0u);
+    }
+    return *this;
+}
+
+ExecutableImage::~ExecutableImage() noexcept {
+    if (m_rwDataFd >= 0)
+        ::close(m_rwDataFd);
+}
+
+ExecutableImage::Instance ExecutableImage::instantiate() const {
+    auto const rwDataMappingSize = roundUpToPageSize(m_rwDataSizeInBytes);
+    auto const bssMappingSize = roundUpToPageSize(m_bssSizeInBytes);
+    if (bssMappingSize > std::numeric_limits<std::size_t>::max()
+                         - rwDataMappingSize)
+        throw std::bad_alloc();
+
+    Instance r;
+    r.m_mappingSize = rwDataMappingSize + bssMappingSize;
+    if (!r.m_mappingSize)
+        return r;
+
+    /* Reserve anonymous zero pages for both sections: */
+    auto const mapping = ::mmap(nullptr,
+                                r.m_mappingSize,
+                                PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS,
+                                -1,
+                                0);
+    if (mapping == MAP_FAILED)
+        throwNested(std::system_error(errno, std::generic_category()),
+                    FailedToMapInstanceException());
+    r.m_mapping = mapping;
+
+    /* Replace the pages of the read-write data section with a copy-on-write
+       view of the shared backing: */
+    if (m_rwDataSizeInBytes) {
+        assert(m_rwDataFd >= 0);
+        if (::mmap(mapping,
+                   m_rwDataSizeInBytes,
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_FIXED,
+                   m_rwDataFd,
+                   0) == MAP_FAILED)
+            throwNested(std::system_error(errno, std::generic_category()),
+                        FailedToMapInstanceException());
+        r.m_rwData = mapping;
+        r.m_rwDataSizeInBytes = m_rwDataSizeInBytes;
+    }
+    if (m_bssSizeInBytes) {
+        r.m_bss = static_cast<char *>(mapping) + rwDataMappingSize;
+        r.m_bssSizeInBytes = m_bssSizeInBytes;
+    }
+    return r;
+}
+
+} // namespace sharemind {
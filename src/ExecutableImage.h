@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#ifndef SHAREMIND_LIBEXECUTABLE_EXECUTABLEIMAGE_H
+#define SHAREMIND_LIBEXECUTABLE_EXECUTABLEIMAGE_H
+
+#include <cstddef>
+#include <sharemind/ExceptionMacros.h>
+#include "Executable.h"
+
+
+namespace sharemind {
+
+/*
+  A template for the writable memory of the instances of a linking unit. The
+  contents of the read-write data section are copied once into a sealed
+  in-memory file, which every instance maps privately, so that pages are only
+  copied once an instance writes to them. The BSS section of every instance is
+  mapped from anonymous memory, which is zero-filled on first access.
+*/
+class ExecutableImage {
+
+public: /* Types: */
+
+    SHAREMIND_DECLARE_EXCEPTION_NOINLINE(Executable::Exception, Exception);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_MSG_NOINLINE(
+            Exception,
+            FailedToCreateBackingException);
+    SHAREMIND_DECLARE_EXCEPTION_CONST_MSG_NOINLINE(
+            Exception,
+            FailedToMapInstanceException);
+
+    /*
+      The writable memory of a single instance. The read-write data section
+      and the BSS section each start at a page boundary.
+    */
+    class Instance {
+
+        friend class ExecutableImage;
+
+    public: /* Methods: */
+
+        Instance() noexcept = default;
+        Instance(Instance && move) noexcept;
+        Instance(Instance const &) = delete;
+
+        Instance & operator=(Instance && move) noexcept;
+        Instance & operator=(Instance const &) = delete;
+
+        ~Instance() noexcept;
+
+        void * rwData() const noexcept { return m_rwData; }
+        std::size_t rwDataSizeInBytes() const noexcept
+        { return m_rwDataSizeInBytes; }
+
+        void * bss() const noexcept { return m_bss; }
+        std::size_t bssSizeInBytes() const noexcept
+        { return m_bssSizeInBytes; }
+
+    private: /* Fields: */
+
+        void * m_mapping = nullptr;
+        std::size_t m_mappingSize = 0u;
+        void * m_rwData = nullptr;
+        std::size_t m_rwDataSizeInBytes = 0u;
+        void * m_bss = nullptr;
+        std::size_t m_bssSizeInBytes = 0u;
+
+    };
+
+public: /* Methods: */
+
+    explicit ExecutableImage(Executable::LinkingUnit const & linkingUnit);
+
+    /* Creates the image of the active linking unit of the executable: */
+    explicit ExecutableImage(Executable const & executable);
+
+    ExecutableImage(ExecutableImage && move) noexcept;
+    ExecutableImage(ExecutableImage const &) = delete;
+
+    ExecutableImage & operator=(ExecutableImage && move) noexcept;
+    ExecutableImage & operator=(ExecutableImage const &) = delete;
+
+    ~ExecutableImage() noexcept;
+
+    std::size_t rwDataSizeInBytes() const noexcept
+    { return m_rwDataSizeInBytes; }
+
+    std::size_t bssSizeInBytes() const noexcept { return m_bssSizeInBytes; }
+
+    /*
+      Maps the writable memory of a new instance. This may be called
+      concurrently from several threads.
+    */
+    Instance instantiate() const;
+
+private: /* Fields: */
+
+    int m_rwDataFd = -1;
+    std::size_t m_rwDataSizeInBytes = 0u;
+    std::size_t m_bssSizeInBytes = 0u;
+
+};
+
+} /* namespace sharemind { */
+
+#endif /* SHAREMIND_LIBEXECUTABLE_EXECUTABLEIMAGE_H */
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#include "ExecutableNumaReplicas.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <linux/mempolicy.h>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+
+namespace sharemind {
+namespace {
+
+/* Large enough for the node masks of any kernel configuration: */
+constexpr unsigned long maxNodes = 1024u;
+constexpr std::size_t nodeMaskWords =
+        maxNodes / (sizeof(unsigned long) * 8u);
+using NodeMask = unsigned long[nodeMaskWords];
+
+/*
+  Returns the sorted list of online NUMA nodes parsed from sysfs, e.g. from
+  "0-1,4", or an empty list if it is unavailable:
+*/
+std::vector<unsigned> onlineNodes() {
+    std::vector<unsigned> r;
+    std::ifstream f("/sys/devices/system/node/online");
+    std::string line;
+    if (!std::getline(f, line))
+        return r;
+    char const * s = line.c_str();
+    while (*s) {
+        char * end;
+        auto const first = std::strtoul(s, &end, 10);
+        if (end == s)
+            return {};
+        auto last = first;
+        s = end;
+        if (*s == '-') {
+            last = std::strtoul(++s, &end, 10);
+            if (end == s || last < first)
+                return {};
+            s = end;
+        }
+        if (last >= maxNodes)
+            return {};
+        for (auto node = first; node <= last; ++node)
+            r.emplace_back(static_cast<unsigned>(node));
+        if (*s == ',')
+            ++s;
+        else if (*s && *s != '\n')
+            return {};
+        else
+            break;
+    }
+    return r;
+}
+
+/*
+  A memory resource which gets all of its storage from fresh anonymous
+  mappings bound to a single NUMA node before they are first touched, so that
+  even small allocations are placed on that node. Failures to bind are
+  ignored, since placement is only an optimization:
+*/
+class NodeMappingResource final : public std::pmr::memory_resource {
+
+public: /* Methods: */
+
+    explicit NodeMappingResource(unsigned node) noexcept {
+        m_nodeMask[node / (sizeof(unsigned long) * 8u)] =
+                1ul << (node % (sizeof(unsigned long) * 8u));
+    }
+
+private: /* Methods: */
+
+    void * do_allocate(std::size_t bytes, std::size_t alignment) final {
+        auto const pageSize = systemPageSize();
+        if (alignment > pageSize)
+            throw std::bad_alloc();
+        if (!bytes)
+            bytes = 1u;
+        void * r;
+        std::size_t mappingSize;
+        if (bytes >= largePageThreshold) {
+            r = mapLargePageStorage(bytes);
+            mappingSize = bytes;
+        } else {
+            mappingSize = (bytes + (pageSize - 1u)) & ~(pageSize - 1u);
+            r = ::mmap(nullptr,
+                       mappingSize,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1,
+                       0);
+            if (r == MAP_FAILED)
+                throw std::bad_alloc();
+        }
+        ::syscall(SYS_mbind,
+                  r,
+                  mappingSize,
+                  MPOL_PREFERRED,
+                  m_nodeMask,
+                  maxNodes,
+                  0u);
+        return r;
+    }
+
+    void do_deallocate(void * ptr, std::size_t bytes, std::size_t) final {
+        if (!bytes)
+            bytes = 1u;
+        if (bytes >= largePageThreshold) {
+            unmapLargePageStorage(ptr, bytes);
+        } else {
+            auto const pageSize = systemPageSize();
+            ::munmap(ptr, (bytes + (pageSize - 1u)) & ~(pageSize - 1u));
+        }
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const & other)
+            const noexcept final
+    { return this == &other; }
+
+    static std::size_t systemPageSize() noexcept {
+        static std::size_t const pageSize =
+                static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return pageSize;
+    }
+
+private: /* Fields: */
+
+    NodeMask m_nodeMask = {};
+
+};
+
+/*
+  Returns a pooling memory resource for the given node. These resources are
+  created on first use and intentionally never destroyed, because sections
+  allocated from them may be shared beyond the lifetime of any replicas:
+*/
+std::pmr::memory_resource * nodeResource(unsigned node) {
+    static std::mutex mutex;
+    static std::vector<std::pmr::memory_resource *> resources;
+    std::lock_guard<std::mutex> const guard(mutex);
+    if (resources.size() <= node)
+        resources.resize(node + 1u, nullptr);
+    auto & resource = resources[node];
+    if (!resource) {
+        std::unique_ptr<NodeMappingResource> upstream(
+                    new NodeMappingResource(node));
+        resource = new std::pmr::synchronized_pool_resource(upstream.get());
+        upstream.release();
+    }
+    return resource;
+}
+
+/*
+  Copies the given section using the given allocator for both the section
+  object and its contents:
+*/
+template <typename Section>
+std::shared_ptr<Section> sectionCopy(
+        Section const & section,
+        Executable::allocator_type const & allocator)
+{
+    return std::allocate_shared<Section>(
+                std::pmr::polymorphic_allocator<Section>(allocator),
+                section,
+                allocator);
+}
+
+} // anonymous namespace
+
+ExecutableNumaReplicas::ExecutableNumaReplicas(Executable const & executable)
+{
+    auto const nodes(onlineNodes());
+    if (nodes.size() <= 1u) {
+        m_replicas.emplace_back(executable, Executable::ShareSections);
+        return;
+    }
+
+    m_replicas.reserve(nodes.size());
+    m_nodeReplicaIndexes.resize(nodes.back() + 1u, 0u);
+    for (auto const node : nodes) {
+        Executable::allocator_type const allocator(nodeResource(node));
+        Executable replica(allocator);
+        replica.fileFormatVersion = executable.fileFormatVersion;
+        replica.activeLinkingUnitIndex = executable.activeLinkingUnitIndex;
+        replica.linkingUnits.reserve(executable.linkingUnits.size());
+        for (auto const & lu : executable.linkingUnits) {
+            replica.linkingUnits.emplace_back(lu, Executable::ShareSections);
+            auto & copy = replica.linkingUnits.back();
+            if (lu.textSection)
+                copy.textSection = sectionCopy(*lu.textSection, allocator);
+            if (lu.roDataSection)
+                copy.roDataSection = sectionCopy(*lu.roDataSection, allocator);
+            if (lu.syscallBindingsSection)
+                copy.syscallBindingsSection =
+                        sectionCopy(*lu.syscallBindingsSection, allocator);
+            if (lu.pdBindingsSection)
+                copy.pdBindingsSection =
+                        sectionCopy(*lu.pdBindingsSection, allocator);
+        }
+        m_replicas.emplace_back(std::move(replica));
+        m_nodeReplicaIndexes[node] = m_replicas.size() - 1u;
+    }
+}
+
+ExecutableNumaReplicas::ExecutableNumaReplicas(ExecutableNumaReplicas &&)
+        noexcept = default;
+
+ExecutableNumaReplicas & ExecutableNumaReplicas::operator=(
+        ExecutableNumaReplicas &&) noexcept = default;
+
+ExecutableNumaReplicas::~ExecutableNumaReplicas() noexcept {}
+
+Executable const & ExecutableNumaReplicas::replicaForNode(unsigned node)
+        const noexcept
+{
+    assert(!m_replicas.empty());
+    return m_replicas[(node < m_nodeReplicaIndexes.size())
+                      ? m_nodeReplicaIndexes[node]
+                      : 0u];
+}
+
+Executable const & ExecutableNumaReplicas::replicaForCurrentNode()
+        const noexcept
+{
+    assert(!m_replicas.empty());
+    if (m_replicas.size() <= 1u)
+        return m_replicas.front();
+    unsigned cpu;
+    unsigned node;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+        return m_replicas.front();
+    return replicaForNode(node);
+}
+
+} // namespace sharemind {
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#ifndef SHAREMIND_LIBEXECUTABLE_EXECUTABLENUMAREPLICAS_H
+#define SHAREMIND_LIBEXECUTABLE_EXECUTABLENUMAREPLICAS_H
+
+#include <cstddef>
+#include <vector>
+#include "Executable.h"
+
+
+namespace sharemind {
+
+/*
+  Copies of an executable for each online NUMA node of the system. In the
+  replica for a node, the text, read-only data and bindings sections are
+  private copies allocated, together with the linking units of the replica,
+  from fresh mappings bound to that node, whereas all other sections are
+  shared with the original executable. On systems with a single node, or
+  without NUMA support, a single replica sharing all sections is made.
+
+  The replicas must not be accessed through a moved-from object.
+*/
+class ExecutableNumaReplicas {
+
+public: /* Methods: */
+
+    explicit ExecutableNumaReplicas(Executable const & executable);
+
+    ExecutableNumaReplicas(ExecutableNumaReplicas &&) noexcept;
+    ExecutableNumaReplicas(ExecutableNumaReplicas const &) = delete;
+
+    ExecutableNumaReplicas & operator=(ExecutableNumaReplicas &&) noexcept;
+    ExecutableNumaReplicas & operator=(ExecutableNumaReplicas const &)
+            = delete;
+
+    ~ExecutableNumaReplicas() noexcept;
+
+    std::size_t numberOfReplicas() const noexcept
+    { return m_replicas.size(); }
+
+    /*
+      Returns the replica for the given NUMA node, or the first replica if
+      there is no replica for that node.
+    */
+    Executable const & replicaForNode(unsigned node) const noexcept;
+
+    /*
+      Returns the replica for the NUMA node of the CPU the calling thread is
+      currently running on. Threads which are not bound to a single node
+      should not keep the result for longer than necessary.
+    */
+    Executable const & replicaForCurrentNode() const noexcept;
+
+private: /* Fields: */
+
+    std::vector<Executable> m_replicas;
+    std::vector<std::size_t> m_nodeReplicaIndexes;
+
+};
+
+} /* namespace sharemind { */
+
+#endif /* SHAREMIND_LIBEXECUTABLE_EXECUTABLENUMAREPLICAS_H */
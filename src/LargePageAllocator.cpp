@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#include "LargePageAllocator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <sys/mman.h>
+
+
+namespace sharemind {
+namespace {
+
+std::atomic<LargePageMode> currentLargePageMode(LargePageMode::Disabled);
+
+std::size_t largeMappingSize(std::size_t size) noexcept
+{ return (size + (largePageThreshold - 1u)) & ~(largePageThreshold - 1u); }
+
+/*
+  The mappings made by allocateLargePageStorage(), which are told apart from
+  storage allocated with operator new, since the large page mode may change
+  before the storage is released. These are never destroyed, since storage
+  may be released during the destruction of other static objects:
+*/
+struct LargeMappings {
+    std::mutex mutex;
+    std::set<void *> mappings;
+};
+
+LargeMappings & largeMappings() {
+    static LargeMappings & r = *new LargeMappings();
+    return r;
+}
+
+} // anonymous namespace
+
+void setLargePageMode(LargePageMode mode) noexcept
+{ currentLargePageMode.store(mode, std::memory_order_relaxed); }
+
+LargePageMode largePageMode() noexcept
+{ return currentLargePageMode.load(std::memory_order_relaxed); }
+
+void * mapLargePageStorage(std::size_t size) {
+    if (size > std::numeric_limits<std::size_t>::max() - largePageThreshold)
+        throw std::bad_alloc();
+    auto const mappingSize = largeMappingSize(size ? size : 1u);
+    auto const mode = largePageMode();
+
+    #ifdef MAP_HUGETLB
+    if (mode == LargePageMode::Explicit) {
+        auto const r = ::mmap(nullptr,
+                              mappingSize,
+                              PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                              -1,
+                              0);
+        if (r != MAP_FAILED)
+            return r;
+    }
+    #endif
+
+    /* Over-allocate to align the mapping to the large page size, so that
+       the kernel can back all of it with huge pages: */
+    auto const r = ::mmap(nullptr,
+                          mappingSize + largePageThreshold,
+                          PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS,
+                          -1,
+                          0);
+    if (r == MAP_FAILED)
+        throw std::bad_alloc();
+    auto const start = reinterpret_cast<std::uintptr_t>(r);
+    auto const alignedStart =
+            (start + (largePageThreshold - 1u)) & ~(largePageThreshold - 1u);
+    if (auto const head = alignedStart - start)
+        ::munmap(r, head);
+    if (auto const tail = largePageThreshold - (alignedStart - start))
+        ::munmap(reinterpret_cast<void *>(alignedStart + mappingSize), tail);
+    auto const aligned = reinterpret_cast<void *>(alignedStart);
+
+    #ifdef MADV_HUGEPAGE
+    if (mode != LargePageMode::Disabled)
+        ::madvise(aligned, mappingSize, MADV_HUGEPAGE);
+    #endif
+    return aligned;
+}
+
+void unmapLargePageStorage(void * ptr, std::size_t size) noexcept
+{ ::munmap(ptr, largeMappingSize(size ? size : 1u)); }
+
+void * allocateLargePageStorage(std::size_t size) {
+    if (size < largePageThreshold
+        || largePageMode() == LargePageMode::Disabled)
+        return ::operator new(size);
+    auto const r = mapLargePageStorage(size);
+    try {
+        auto & registry = largeMappings();
+        std::lock_guard<std::mutex> const guard(registry.mutex);
+        registry.mappings.emplace(r);
+    } catch (...) {
+        unmapLargePageStorage(r, size);
+        throw;
+    }
+    return r;
+}
+
+void deallocateLargePageStorage(void * ptr, std::size_t size) noexcept {
+    if (size >= largePageThreshold) {
+        auto & registry = largeMappings();
+        std::lock_guard<std::mutex> const guard(registry.mutex);
+        if (registry.mappings.erase(ptr)) {
+            unmapLargePageStorage(ptr, size);
+            return;
+        }
+    }
+    ::operator delete(ptr);
+}
+
+} // namespace sharemind {
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#ifndef SHAREMIND_LIBEXECUTABLE_LARGEPAGEALLOCATOR_H
+#define SHAREMIND_LIBEXECUTABLE_LARGEPAGEALLOCATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace sharemind {
+
+/*
+  Selects how storage of at least largePageThreshold bytes for section data
+  is backed. Disabled uses ordinary pages, Transparent asks the kernel to back
+  the storage with transparent huge pages, and Explicit tries to allocate
+  huge pages from the reserved pool first, falling back to Transparent.
+*/
+enum class LargePageMode { Disabled, Transparent, Explicit };
+
+constexpr std::size_t largePageThreshold = 2u * 1024u * 1024u;
+
+/* Sets or gets the process-wide large page mode, initially Disabled: */
+void setLargePageMode(LargePageMode mode) noexcept;
+LargePageMode largePageMode() noexcept;
+
+/*
+  Allocates uninitialized storage of the given size. Unless the large page
+  mode is Disabled, storage of at least largePageThreshold bytes is mapped by
+  mapLargePageStorage(), otherwise it is allocated with operator new. The
+  storage must be released by deallocateLargePageStorage() with the same
+  size.
+*/
+void * allocateLargePageStorage(std::size_t size);
+void deallocateLargePageStorage(void * ptr, std::size_t size) noexcept;
+
+/*
+  Maps fresh anonymous storage of the given size aligned to the large page
+  size, backed by huge pages as selected by the large page mode, regardless
+  of the size. The storage must be released by unmapLargePageStorage() with
+  the same size.
+*/
+void * mapLargePageStorage(std::size_t size);
+void unmapLargePageStorage(void * ptr, std::size_t size) noexcept;
+
+/*
+  Passing this to LargePageAllocator::construct() default-initializes the
+  element, which leaves elements of trivial types uninitialized:
+*/
+enum DefaultInitializeTag { DefaultInitialize };
+
+/*
+  An allocator using allocateLargePageStorage(), or the given memory resource
+  if any. Like std::pmr::polymorphic_allocator, copies of containers use no
+  memory resource, but unlike it, the memory resource is propagated on move
+  assignment and swap.
+*/
+template <typename T>
+class LargePageAllocator {
+
+public: /* Types: */
+
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+public: /* Methods: */
+
+    LargePageAllocator() noexcept = default;
+
+    explicit LargePageAllocator(std::pmr::memory_resource * resource) noexcept
+        : m_resource(resource)
+    {}
+
+    template <typename U>
+    LargePageAllocator(LargePageAllocator<U> const & copy) noexcept
+        : m_resource(copy.resource())
+    {}
+
+    T * allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        if (m_resource)
+            return static_cast<T *>(
+                        m_resource->allocate(n * sizeof(T), alignof(T)));
+        return static_cast<T *>(allocateLargePageStorage(n * sizeof(T)));
+    }
+
+    void deallocate(T * ptr, std::size_t n) noexcept {
+        if (m_resource) {
+            m_resource->deallocate(ptr, n * sizeof(T), alignof(T));
+        } else {
+            deallocateLargePageStorage(ptr, n * sizeof(T));
+        }
+    }
+
+    template <typename U>
+    void construct(U * ptr, DefaultInitializeTag const)
+            noexcept(std::is_nothrow_default_constructible<U>::value)
+    { ::new (static_cast<void *>(ptr)) U; }
+
+    LargePageAllocator select_on_container_copy_construction() const noexcept
+    { return LargePageAllocator(); }
+
+    std::pmr::memory_resource * resource() const noexcept
+    { return m_resource; }
+
+    template <typename U>
+    bool operator==(LargePageAllocator<U> const & rhs) const noexcept {
+        return (m_resource == rhs.resource())
+               || (m_resource
+                   && rhs.resource()
+                   && m_resource->is_equal(*rhs.resource()));
+    }
+
+    template <typename U>
+    bool operator!=(LargePageAllocator<U> const & rhs) const noexcept
+    { return !(*this == rhs); }
+
+private: /* Fields: */
+
+    std::pmr::memory_resource * m_resource = nullptr;
+
+};
+
+namespace Detail {
+
+/*
+  Yields tags for default-initializing elements, see below. It is a random
+  access iterator, so that the size of a range is computed in constant time:
+*/
+class DefaultInitializeTagIterator {
+
+public: /* Types: */
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = DefaultInitializeTag;
+    using difference_type = std::ptrdiff_t;
+    using pointer = DefaultInitializeTag const *;
+    using reference = DefaultInitializeTag;
+
+public: /* Methods: */
+
+    explicit DefaultInitializeTagIterator(std::size_t index) noexcept
+        : m_index(index)
+    {}
+
+    reference operator*() const noexcept { return DefaultInitialize; }
+    reference operator[](difference_type) const noexcept
+    { return DefaultInitialize; }
+
+    DefaultInitializeTagIterator & operator++() noexcept {
+        ++m_index;
+        return *this;
+    }
+
+    DefaultInitializeTagIterator operator++(int) noexcept {
+        DefaultInitializeTagIterator r(*this);
+        ++m_index;
+        return r;
+    }
+
+    DefaultInitializeTagIterator & operator--() noexcept {
+        --m_index;
+        return *this;
+    }
+
+    DefaultInitializeTagIterator operator--(int) noexcept {
+        DefaultInitializeTagIterator r(*this);
+        --m_index;
+        return r;
+    }
+
+    DefaultInitializeTagIterator & operator+=(difference_type n) noexcept {
+        m_index += static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    DefaultInitializeTagIterator & operator-=(difference_type n) noexcept {
+        m_index -= static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    DefaultInitializeTagIterator operator+(difference_type n) const noexcept
+    { return DefaultInitializeTagIterator(*this) += n; }
+
+    friend DefaultInitializeTagIterator operator+(
+            difference_type n,
+            DefaultInitializeTagIterator const & it) noexcept
+    { return it + n; }
+
+    DefaultInitializeTagIterator operator-(difference_type n) const noexcept
+    { return DefaultInitializeTagIterator(*this) -= n; }
+
+    difference_type operator-(DefaultInitializeTagIterator const & rhs)
+            const noexcept
+    { return static_cast<difference_type>(m_index - rhs.m_index); }
+
+    bool operator==(DefaultInitializeTagIterator const & rhs) const noexcept
+    { return m_index == rhs.m_index; }
+
+    bool operator!=(DefaultInitializeTagIterator const & rhs) const noexcept
+    { return m_index != rhs.m_index; }
+
+    bool operator<(DefaultInitializeTagIterator const & rhs) const noexcept
+    { return m_index < rhs.m_index; }
+
+    bool operator>(DefaultInitializeTagIterator const & rhs) const noexcept
+    { return m_index > rhs.m_index; }
+
+    bool operator<=(DefaultInitializeTagIterator const & rhs) const noexcept
+    { return m_index <= rhs.m_index; }
+
+    bool operator>=(DefaultInitializeTagIterator const & rhs) const noexcept
+    { return m_index >= rhs.m_index; }
+
+private: /* Fields: */
+
+    std::size_t m_index;
+
+};
+
+} /* namespace Detail { */
+
+/*
+  Returns a vector of the given number of default-initialized elements, i.e.
+  of uninitialized elements if T is trivial. This avoids writing to storage
+  which the caller overwrites anyway, whereas constructing or resizing the
+  vector would value-initialize the elements.
+*/
+template <typename T>
+std::vector<T, LargePageAllocator<T> > makeDefaultInitializedVector(
+        std::size_t size,
+        LargePageAllocator<T> const & allocator = LargePageAllocator<T>())
+{
+    /* Constructing from a range of tags calls construct() with each tag: */
+    using Detail::DefaultInitializeTagIterator;
+    return std::vector<T, LargePageAllocator<T> >(
+                DefaultInitializeTagIterator(0u),
+                DefaultInitializeTagIterator(size),
+                allocator);
+}
+
+} /* namespace sharemind { */
+
+#endif /* SHAREMIND_LIBEXECUTABLE_LARGEPAGEALLOCATOR_H */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#include "LazyExecutable.h"
+
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+namespace sharemind {
+
+LazyExecutable::LinkingUnit::LinkingUnit(
+        std::shared_ptr<void> data,
+        std::shared_ptr<Executable::TableOfContents const> toc,
+        std::size_t index) noexcept
+    : m_data(std::move(data))
+    , m_toc(std::move(toc))
+    , m_index(index)
+{}
+
+template <typename Section>
+std::shared_ptr<Section> LazyExecutable::LinkingUnit::section(
+        Executable::TableOfContents::SectionType type,
+        std::shared_ptr<Section> Executable::LinkingUnit::* member) const
+{
+    using STU = std::underlying_type<decltype(type)>::type;
+    auto const mask = 1u << static_cast<STU>(type);
+
+    std::lock_guard<std::mutex> const guard(m_mutex);
+    if (!(m_materializedSections & mask)) {
+        auto const & sections = tableOfContents().sections;
+        for (std::size_t i = 0u; i < sections.size(); ++i) {
+            if (sections[i].type == type) {
+                m_toc->materializeSection(m_sections,
+                                          m_index,
+                                          i,
+                                          m_data.get(),
+                                          m_data);
+                break;
+            }
+        }
+        m_materializedSections |= mask;
+    }
+    return m_sections.*member;
+}
+
+#define SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER(Type,name,sType) \
+    std::shared_ptr<Executable::Type> \
+    LazyExecutable::LinkingUnit::name ## Section() const { \
+        return section(Executable::TableOfContents::SectionType::sType, \
+                       &Executable::LinkingUnit::name ## Section); \
+    }
+SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER(TextSection, text, Text)
+SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER(DataSection, roData, RoData)
+SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER(DataSection, rwData, Data)
+SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER(BssSection, bss, Bss)
+SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER(SyscallBindingsSection,
+                                        syscallBindings,
+                                        Bind)
+SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER(PdBindingsSection, pdBindings, PdBind)
+SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER(DataSection, debug, Debug)
+#undef SHAREMIND_LAZYEXECUTABLE_SECTION_GETTER
+
+Executable::LinkingUnit LazyExecutable::LinkingUnit::materialize() const {
+    Executable::LinkingUnit r;
+    r.textSection = textSection();
+    r.roDataSection = roDataSection();
+    /* The writable sections are copied to keep the cached ones intact: */
+    if (auto const rwData = rwDataSection())
+        r.rwDataSection = std::make_shared<Executable::DataSection>(*rwData);
+    if (auto const bss = bssSection())
+        r.bssSection = std::make_shared<Executable::BssSection>(*bss);
+    r.syscallBindingsSection = syscallBindingsSection();
+    r.pdBindingsSection = pdBindingsSection();
+    r.debugSection = debugSection();
+    return r;
+}
+
+
+LazyExecutable::LazyExecutable(std::shared_ptr<void> data, std::size_t size) {
+    assert(data || !size);
+    auto toc(std::make_shared<Executable::TableOfContents>());
+    toc->scan(data ? data.get() : "", size);
+    m_toc = std::move(toc);
+
+    auto const numLinkingUnits = m_toc->linkingUnits.size();
+    m_linkingUnits.reserve(numLinkingUnits);
+    for (std::size_t i = 0u; i < numLinkingUnits; ++i)
+        m_linkingUnits.emplace_back(new LinkingUnit(data, m_toc, i));
+}
+
+LazyExecutable::LazyExecutable(char const * filename)
+    : LazyExecutable(
+          [filename]() {
+              std::size_t size;
+              auto mapping(Executable::mapFile(filename, size));
+              return std::make_pair(std::move(mapping), size);
+          }())
+{}
+
+LazyExecutable::LazyExecutable(
+        std::pair<std::shared_ptr<void>, std::size_t> && image)
+    : LazyExecutable(std::move(image.first), image.second)
+{}
+
+LazyExecutable::LazyExecutable(LazyExecutable &&) noexcept = default;
+
+LazyExecutable & LazyExecutable::operator=(LazyExecutable &&) noexcept
+        = default;
+
+LazyExecutable::~LazyExecutable() noexcept = default;
+
+Executable LazyExecutable::materialize() const {
+    Executable r;
+    r.fileFormatVersion = fileFormatVersion();
+    r.activeLinkingUnitIndex = activeLinkingUnitIndex();
+    r.linkingUnits.reserve(m_linkingUnits.size());
+    for (auto const & lu : m_linkingUnits)
+        r.linkingUnits.emplace_back(lu->materialize());
+    return r;
+}
+
+} // namespace sharemind {
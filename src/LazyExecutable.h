@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#ifndef SHAREMIND_LIBEXECUTABLE_LAZYEXECUTABLE_H
+#define SHAREMIND_LIBEXECUTABLE_LAZYEXECUTABLE_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Executable.h"
+
+
+namespace sharemind {
+
+/*
+  An executable of which only the headers have been parsed. The sections of
+  its linking units are deserialized from the underlying image only when
+  first accessed, after which they are cached.
+*/
+class LazyExecutable {
+
+public: /* Types: */
+
+    class LinkingUnit {
+
+        friend class LazyExecutable;
+
+    public: /* Methods: */
+
+        LinkingUnit(LinkingUnit &&) = delete;
+        LinkingUnit(LinkingUnit const &) = delete;
+
+        LinkingUnit & operator=(LinkingUnit &&) = delete;
+        LinkingUnit & operator=(LinkingUnit const &) = delete;
+
+        /*
+          These return the cached sections, which are shared by all callers
+          and must therefore not be modified, see
+          Executable::LinkingUnit::unshareSection().
+        */
+        std::shared_ptr<Executable::TextSection> textSection() const;
+        std::shared_ptr<Executable::DataSection> roDataSection() const;
+        std::shared_ptr<Executable::DataSection> rwDataSection() const;
+        std::shared_ptr<Executable::BssSection> bssSection() const;
+        std::shared_ptr<Executable::SyscallBindingsSection>
+        syscallBindingsSection() const;
+        std::shared_ptr<Executable::PdBindingsSection>
+        pdBindingsSection() const;
+        std::shared_ptr<Executable::DataSection> debugSection() const;
+
+        /*
+          Materializes all sections of the linking unit. The read-only
+          sections are shared with the cache, like with ShareSections,
+          whereas the read-write data and bss sections are private copies.
+        */
+        Executable::LinkingUnit materialize() const;
+
+        Executable::TableOfContents::LinkingUnit const & tableOfContents()
+                const noexcept
+        { return m_toc->linkingUnits[m_index]; }
+
+        std::size_t numberOfSections() const noexcept
+        { return tableOfContents().sections.size(); }
+
+    private: /* Methods: */
+
+        LinkingUnit(std::shared_ptr<void> data,
+                    std::shared_ptr<Executable::TableOfContents const> toc,
+                    std::size_t index) noexcept;
+
+        template <typename Section>
+        std::shared_ptr<Section> section(
+                Executable::TableOfContents::SectionType type,
+                std::shared_ptr<Section> Executable::LinkingUnit::* member)
+                const;
+
+    private: /* Fields: */
+
+        std::shared_ptr<void> const m_data;
+        std::shared_ptr<Executable::TableOfContents const> const m_toc;
+        std::size_t const m_index;
+
+        mutable std::mutex m_mutex;
+        mutable unsigned m_materializedSections = 0u;
+        mutable Executable::LinkingUnit m_sections;
+
+    };
+
+public: /* Methods: */
+
+    /*
+      Parses the headers of the executable image in the given buffer. The
+      sections refer to the buffer, which is kept alive for as long as the
+      LazyExecutable or any of its materialized data sections exist.
+    */
+    LazyExecutable(std::shared_ptr<void> data, std::size_t size);
+
+    /*
+      Maps the given file into memory and parses its headers. Since sections
+      are read from the mapping when first accessed, the file must not be
+      modified in place, see Executable::FileLoadMode::Map.
+    */
+    explicit LazyExecutable(char const * filename);
+    explicit LazyExecutable(std::string const & filename)
+        : LazyExecutable(filename.c_str())
+    {}
+
+    LazyExecutable(LazyExecutable &&) noexcept;
+    LazyExecutable(LazyExecutable const &) = delete;
+
+    LazyExecutable & operator=(LazyExecutable &&) noexcept;
+    LazyExecutable & operator=(LazyExecutable const &) = delete;
+
+    ~LazyExecutable() noexcept;
+
+    std::size_t fileFormatVersion() const noexcept
+    { return m_toc->fileFormatVersion; }
+
+    std::size_t activeLinkingUnitIndex() const noexcept
+    { return m_toc->activeLinkingUnitIndex; }
+
+    std::size_t numberOfLinkingUnits() const noexcept
+    { return m_linkingUnits.size(); }
+
+    LinkingUnit const & linkingUnit(std::size_t index) const noexcept
+    { return *m_linkingUnits[index]; }
+
+    LinkingUnit const & activeLinkingUnit() const noexcept
+    { return linkingUnit(activeLinkingUnitIndex()); }
+
+    Executable::TableOfContents const & tableOfContents() const noexcept
+    { return *m_toc; }
+
+    /*
+      Materializes all sections of all linking units, sharing them as
+      described for LinkingUnit::materialize().
+    */
+    Executable materialize() const;
+
+private: /* Methods: */
+
+    LazyExecutable(std::pair<std::shared_ptr<void>, std::size_t> && image);
+
+private: /* Fields: */
+
+    std::shared_ptr<Executable::TableOfContents const> m_toc;
+    std::vector<std::unique_ptr<LinkingUnit> > m_linkingUnits;
+
+};
+
+} /* namespace sharemind { */
+
+#endif /* SHAREMIND_LIBEXECUTABLE_LAZYEXECUTABLE_H */
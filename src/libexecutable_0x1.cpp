@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#include "libexecutable_0x1.h"
+
+#include <cassert>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sharemind/codeblock.h>
+#include <sharemind/IntegralComparisons.h>
+#include <type_traits>
+#include <utility>
+
+
+namespace {
+
+template <typename T>
+std::istream & deserialize(std::istream & is, T & h) {
+    if (is.read(reinterpret_cast<char *>(&h), sizeof(h)))
+        if (!h.isValid())
+            is.setstate(std::ios_base::failbit);
+    return is;
+}
+
+template <typename T>
+std::ostream & serialize(std::ostream & os, T const & h) {
+    static_assert(sharemind::integralLessEqual(
+                      sizeof(h),
+                      std::numeric_limits<std::streamsize>::max()), "");
+    return os.write(reinterpret_cast<char const *>(&h),
+                    static_cast<std::streamsize>(sizeof(h)));
+}
+
+} // anonymous namespace
+
+std::istream & operator>>(std::istream & is, sharemind::ExecutableHeader0x1 & h)
+{ return deserialize(is, h); }
+
+std::ostream & operator<<(std::ostream & os,
+                          sharemind::ExecutableHeader0x1 const & h)
+{ return serialize(os, h); }
+
+std::istream & operator>>(std::istream & is,
+                          sharemind::ExecutableSectionHeader0x1 & h)
+{ return deserialize(is, h); }
+
+std::ostream & operator<<(std::ostream & os,
+                          sharemind::ExecutableSectionHeader0x1 const & h)
+{ return serialize(os, h); }
+
+namespace sharemind {
+
+static_assert(sizeof(ExecutableHeader0x1) == 4u + 4u + 1u + 7u, "");
+static_assert(sizeof(ExecutableHeader0x1) % 8u == 0u, "");
+static_assert(std::is_pod<ExecutableHeader0x1>::value, "");
+static_assert(sizeof(ExecutableSectionHeader0x1)
+              == 32u + 8u + 8u + 4u + 4u + 1u + 1u + 6u, "");
+static_assert(sizeof(ExecutableSectionHeader0x1) % 8u == 0u, "");
+static_assert(std::is_pod<ExecutableSectionHeader0x1>::value, "");
+
+namespace {
+
+using HeaderTypeHeader = std::array<char, 32u>;
+
+using ST = ExecutableSectionHeader0x1::SectionType;
+std::array<HeaderTypeHeader,
+           static_cast<std::underlying_type<ST>::type>(ST::Count)> const
+        sMagic{HeaderTypeHeader{"TEXT"},
+               HeaderTypeHeader{"RODATA"},
+               HeaderTypeHeader{"DATA"},
+               HeaderTypeHeader{"BSS"},
+               HeaderTypeHeader{"BIND"},
+               HeaderTypeHeader{"PDBIND"},
+               HeaderTypeHeader{"DEBUG"}};
+
+} // anonymous namespace
+
+void ExecutableHeader0x1::init(NumLinkingUnitsSize numberOfUnitsMinusOne,
+                               ActiveLinkingUnitIndex activeLinkingUnit,
+                               PayloadAlignmentLog2 payloadAlignmentLog2)
+        noexcept
+{
+    setNumberOfLinkingUnitsMinusOne(numberOfUnitsMinusOne);
+    setActiveLinkingUnitIndex(activeLinkingUnit);
+    m_payloadAlignmentLog2 = payloadAlignmentLog2;
+    std::memset(m_zeroPadding.data(), '\0', m_zeroPadding.size());
+}
+
+bool ExecutableHeader0x1::isValid() const noexcept {
+    if (activeLinkingUnitIndex() > numberOfLinkingUnitsMinusOne())
+        return false;
+    if (m_payloadAlignmentLog2 < minPayloadAlignmentLog2
+        || m_payloadAlignmentLog2 > maxPayloadAlignmentLog2)
+        return false;
+    for (auto const c : m_zeroPadding)
+        if (c != '\0')
+            return false;
+    return true;
+}
+
+bool ExecutableHeader0x1::deserializeFrom(void const * data) noexcept {
+    assert(data);
+
+    ExecutableHeader0x1 buf;
+    std::memcpy(&buf, data, sizeof(buf));
+    if (!buf.isValid())
+        return false;
+    (*this) = std::move(buf);
+    return true;
+}
+
+void ExecutableSectionHeader0x1::init(SectionType type,
+                                      SizeType length,
+                                      StoredSizeType storedSize,
+                                      Compression compression,
+                                      BlockSizeType blockSize) noexcept
+{
+    setType(std::move(type));
+    m_length = hostToLittleEndian(length);
+    m_blockSize = hostToLittleEndian(blockSize);
+    m_storedSize = hostToLittleEndian(storedSize);
+    m_checksum = 0u;
+    m_compression = static_cast<std::uint8_t>(compression);
+    m_flags = 0u;
+    std::memset(m_zeroPadding.data(), '\0', m_zeroPadding.size());
+}
+
+bool ExecutableSectionHeader0x1::isValid() const noexcept {
+    auto const sectionType = type();
+    if (sectionType == SectionType::Invalid)
+        return false;
+    switch (compression()) {
+    case Compression::None:
+        {
+            /* Uncompressed contents are stored as in format 0x0: */
+            StoredSizeType expectedStoredSize = size();
+            if (sectionType == SectionType::Bss) {
+                expectedStoredSize = 0u;
+            } else if (sectionType == SectionType::Text) {
+                if (expectedStoredSize
+                    > std::numeric_limits<StoredSizeType>::max()
+                      / sizeof(SharemindCodeBlock))
+                    return false;
+                expectedStoredSize *= sizeof(SharemindCodeBlock);
+            }
+            if (storedSize() != expectedStoredSize || blockSize() != 0u)
+                return false;
+        }
+        break;
+    case Compression::Zstd:
+        if (sectionType == SectionType::Bss || blockSize() == 0u)
+            return false;
+        break;
+    default:
+        return false;
+    }
+    if (m_flags & ~HasChecksumFlag)
+        return false;
+    if ((!hasChecksum() || !storedSize()) && m_checksum != 0u)
+        return false;
+    for (auto const c : m_zeroPadding)
+        if (c != '\0')
+            return false;
+    return true;
+}
+
+bool ExecutableSectionHeader0x1::deserializeFrom(void const * data) noexcept {
+    assert(data);
+
+    ExecutableSectionHeader0x1 buf;
+    std::memcpy(&buf, data, sizeof(buf));
+    if (!buf.isValid())
+        return false;
+    (*this) = std::move(buf);
+    return true;
+}
+
+ExecutableSectionHeader0x1::SectionType ExecutableSectionHeader0x1::type()
+        const noexcept
+{
+#define MATCH_TYPE(e) \
+    if (m_type \
+        == sMagic[static_cast<decltype(sMagic)::size_type>(SectionType::e)]) \
+        return SectionType::e
+    MATCH_TYPE(Text);
+    MATCH_TYPE(RoData);
+    MATCH_TYPE(Data);
+    MATCH_TYPE(Bss);
+    MATCH_TYPE(Bind);
+    MATCH_TYPE(PdBind);
+    MATCH_TYPE(Debug);
+#undef MATCH_TYPE
+    return SectionType::Invalid;
+}
+
+void ExecutableSectionHeader0x1::setType(SectionType type) noexcept {
+    if (type == SectionType::Invalid) {
+        m_type = decltype(m_type){"<INVALID>"};
+    } else {
+        m_type = sMagic[static_cast<decltype(sMagic)::size_type>(type)];
+    }
+}
+
+} // namespace sharemind {
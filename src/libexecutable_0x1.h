@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+#ifndef SHAREMIND_LIBEXECUTABLE_LIBEXECUTABLE_0x1_H
+#define SHAREMIND_LIBEXECUTABLE_LIBEXECUTABLE_0x1_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <sharemind/EndianMacros.h>
+#include "libexecutable_0x0.h"
+
+
+namespace sharemind {
+class ExecutableHeader0x1;
+class ExecutableSectionHeader0x1;
+}
+
+std::istream & operator>>(std::istream &, sharemind::ExecutableHeader0x1 &);
+std::ostream & operator<<(std::ostream &,
+                          sharemind::ExecutableHeader0x1 const &);
+
+std::istream & operator>>(std::istream &,
+                          sharemind::ExecutableSectionHeader0x1 &);
+std::ostream & operator<<(std::ostream &,
+                          sharemind::ExecutableSectionHeader0x1 const &);
+
+namespace sharemind {
+
+/*******************************************************************************
+  Format 0x1 header.
+
+  Unlike in format 0x0, the number of linking units and the index of the
+  active linking unit are 32-bit little-endian integers. The header also
+  specifies the alignment of section payloads relative to the start of the
+  executable. Each payload is preceded by zero padding up to the next multiple
+  of the alignment, except for payloads of zero bytes, which are not aligned.
+*******************************************************************************/
+
+class ExecutableHeader0x1 {
+
+    friend std::istream & ::operator>>(std::istream &, ExecutableHeader0x1 &);
+    friend std::ostream & ::operator<<(std::ostream &,
+                                       ExecutableHeader0x1 const &);
+
+public: /* Types: */
+
+    using NumLinkingUnitsSize = std::uint32_t;
+    using ActiveLinkingUnitIndex = NumLinkingUnitsSize;
+    using PayloadAlignmentLog2 = std::uint8_t;
+
+public: /* Constants: */
+
+    /* Payloads are always aligned to at least 8 bytes, and at most 2 MiB: */
+    static constexpr PayloadAlignmentLog2 const minPayloadAlignmentLog2 = 3u;
+    static constexpr PayloadAlignmentLog2 const maxPayloadAlignmentLog2 = 21u;
+
+public: /* Methods: */
+
+    void init(NumLinkingUnitsSize numberOfUnitsMinusOne,
+              ActiveLinkingUnitIndex activeLinkingUnit,
+              PayloadAlignmentLog2 payloadAlignmentLog2) noexcept;
+
+    bool isValid() const noexcept;
+
+    void serializeTo(void * buffer) const noexcept
+    { std::memcpy(buffer, this, sizeof(*this)); }
+
+    bool deserializeFrom(void const * data) noexcept
+        __attribute__ ((nonnull(2), warn_unused_result));
+
+    NumLinkingUnitsSize numberOfLinkingUnitsMinusOne() const noexcept
+    { return littleEndianToHost(m_numberOfLinkingUnitsMinusOne); }
+
+    void setNumberOfLinkingUnitsMinusOne(
+            NumLinkingUnitsSize const numberOfLinkingUnitsMinusOne) noexcept
+    {
+        m_numberOfLinkingUnitsMinusOne =
+                hostToLittleEndian(numberOfLinkingUnitsMinusOne);
+    }
+
+    void setActiveLinkingUnitIndex(
+            ActiveLinkingUnitIndex const activeLinkingUnitIndex) noexcept
+    { m_activeLinkingUnitIndex = hostToLittleEndian(activeLinkingUnitIndex); }
+
+    ActiveLinkingUnitIndex activeLinkingUnitIndex() const noexcept
+    { return littleEndianToHost(m_activeLinkingUnitIndex); }
+
+    PayloadAlignmentLog2 payloadAlignmentLog2() const noexcept
+    { return m_payloadAlignmentLog2; }
+
+    void setPayloadAlignmentLog2(
+            PayloadAlignmentLog2 const payloadAlignmentLog2) noexcept
+    { m_payloadAlignmentLog2 = payloadAlignmentLog2; }
+
+private: /* Fields: */
+
+    NumLinkingUnitsSize m_numberOfLinkingUnitsMinusOne;
+    ActiveLinkingUnitIndex m_activeLinkingUnitIndex;
+    PayloadAlignmentLog2 m_payloadAlignmentLog2;
+    std::array<char,
+               8u - ((sizeof(m_numberOfLinkingUnitsMinusOne)
+                      + sizeof(m_activeLinkingUnitIndex)
+                      + sizeof(m_payloadAlignmentLog2)) % 8u)>
+            m_zeroPadding;
+
+};
+
+
+/*******************************************************************************
+  Format 0x1 unit header, unchanged from format 0x0.
+*******************************************************************************/
+
+using ExecutableLinkingUnitHeader0x1 = ExecutableLinkingUnitHeader0x0;
+
+
+/*******************************************************************************
+  Format 0x1 section header.
+
+  Unlike in format 0x0, the size of the section is a 64-bit little-endian
+  integer. In addition, this specifies how the contents of the section are
+  stored. Uncompressed contents are stored
+  as in format 0x0. Compressed contents are split into blocks of blockSize()
+  uncompressed bytes each (except for the last one, which may be shorter)
+  which are compressed independently of each other. These are stored as a
+  table of the 32-bit little-endian compressed sizes of all blocks, followed by
+  the compressed blocks in order. In both cases, storedSize() is the number of
+  bytes stored, and these are followed by zero padding to the next multiple of
+  8 bytes. If hasChecksum() is set, checksum() is the CRC-32C of the stored
+  bytes, excluding the padding.
+*******************************************************************************/
+
+class ExecutableSectionHeader0x1 {
+
+    friend std::istream & ::operator>>(std::istream &,
+                                       ExecutableSectionHeader0x1 &);
+    friend std::ostream & ::operator<<(std::ostream &,
+                                       ExecutableSectionHeader0x1 const &);
+
+public: /* Types: */
+
+    using SizeType = std::uint64_t;
+    using StoredSizeType = std::uint64_t;
+    using BlockSizeType = std::uint32_t;
+    using ChecksumType = std::uint32_t;
+    using SectionType = ExecutableSectionHeader0x0::SectionType;
+
+    enum class Compression : std::uint8_t {
+        None = 0,
+        Zstd = 1
+    };
+
+public: /* Methods: */
+
+    void init(SectionType type,
+              SizeType length,
+              StoredSizeType storedSize,
+              Compression compression,
+              BlockSizeType blockSize) noexcept;
+
+    bool isValid() const noexcept;
+
+    void serializeTo(void * buffer) const noexcept
+    { std::memcpy(buffer, this, sizeof(*this)); }
+
+    bool deserializeFrom(void const * data) noexcept
+        __attribute__ ((nonnull(2), warn_unused_result));
+
+    SectionType type() const noexcept;
+    void setType(SectionType const type) noexcept;
+
+    SizeType size() const noexcept { return littleEndianToHost(m_length); }
+
+    void setSize(SizeType const size) noexcept
+    { m_length = hostToLittleEndian(size); }
+
+    StoredSizeType storedSize() const noexcept
+    { return littleEndianToHost(m_storedSize); }
+
+    void setStoredSize(StoredSizeType const storedSize) noexcept
+    { m_storedSize = hostToLittleEndian(storedSize); }
+
+    Compression compression() const noexcept
+    { return static_cast<Compression>(m_compression); }
+
+    void setCompression(Compression const compression) noexcept
+    { m_compression = static_cast<std::uint8_t>(compression); }
+
+    BlockSizeType blockSize() const noexcept
+    { return littleEndianToHost(m_blockSize); }
+
+    void setBlockSize(BlockSizeType const blockSize) noexcept
+    { m_blockSize = hostToLittleEndian(blockSize); }
+
+    bool hasChecksum() const noexcept { return m_flags & HasChecksumFlag; }
+
+    ChecksumType checksum() const noexcept
+    { return littleEndianToHost(m_checksum); }
+
+    void setChecksum(ChecksumType const checksum) noexcept {
+        m_flags |= HasChecksumFlag;
+        m_checksum = hostToLittleEndian(checksum);
+    }
+
+    void clearChecksum() noexcept {
+        m_flags &= static_cast<std::uint8_t>(~HasChecksumFlag);
+        m_checksum = 0u;
+    }
+
+private: /* Constants: */
+
+    static constexpr std::uint8_t const HasChecksumFlag = 0x1u;
+
+private: /* Fields: */
+
+    std::array<char, 32u> m_type;
+    SizeType m_length;
+    StoredSizeType m_storedSize;
+    BlockSizeType m_blockSize;
+    ChecksumType m_checksum;
+    std::uint8_t m_compression;
+    std::uint8_t m_flags;
+    std::array<char,
+               8u - ((sizeof(m_type)
+                      + sizeof(m_length)
+                      + sizeof(m_storedSize)
+                      + sizeof(m_blockSize)
+                      + sizeof(m_checksum)
+                      + sizeof(m_compression)
+                      + sizeof(m_flags)) % 8u)>
+            m_zeroPadding;
+
+};
+
+} /* namespace sharemind { */
+
+#endif /* SHAREMIND_LIBEXECUTABLE_LIBEXECUTABLE_0x1_H */
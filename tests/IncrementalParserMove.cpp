@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) Cybernetica
+ *
+ * Research/Commercial License Usage
+ * Licensees holding a valid Research License or Commercial License
+ * for the Software may use this file according to the written
+ * agreement between you and Cybernetica.
+ *
+ * GNU General Public License Usage
+ * Alternatively, this file may be used under the terms of the GNU
+ * General Public License version 3.0 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.  Please review the following information to
+ * ensure the GNU General Public License version 3.0 requirements will be
+ * met: http://www.gnu.org/copyleft/gpl-3.0.html.
+ *
+ * For further information, please contact us at sharemind@cyber.ee.
+ */
+
+
+/*
+  Checks that an incremental parser which is moved in the middle of the input,
+  e.g. in the middle of a header, continues deserializing correctly and does
+  not depend on the moved-from parser afterwards.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../src/Executable.h"
+
+
+namespace {
+
+using sharemind::Executable;
+using Parser = Executable::IncrementalParser;
+
+Executable makeExecutable(std::size_t formatVersion) {
+    Executable r;
+    r.fileFormatVersion = formatVersion;
+    r.linkingUnits.resize(2u);
+    for (auto & lu : r.linkingUnits) {
+        Executable::TextSection::Container instructions(16u);
+        for (std::size_t i = 0u; i < instructions.size(); ++i)
+            instructions[i].uint64[0] = i;
+        lu.textSection =
+                std::make_shared<Executable::TextSection>(
+                    std::move(instructions));
+        std::vector<char> roData(100u);
+        for (std::size_t i = 0u; i < roData.size(); ++i)
+            roData[i] = static_cast<char>(i * 31u);
+        lu.roDataSection =
+                std::make_shared<Executable::DataSection>(
+                    roData.data(),
+                    roData.size(),
+                    Executable::DataSection::CopyData);
+        lu.bssSection = std::make_shared<Executable::BssSection>(1024u);
+        lu.syscallBindingsSection =
+                std::make_shared<Executable::SyscallBindingsSection>();
+        lu.syscallBindingsSection->syscallBindings.push_back("syscall");
+        lu.pdBindingsSection =
+                std::make_shared<Executable::PdBindingsSection>();
+        lu.pdBindingsSection->pdBindings.push_back("pd");
+    }
+    r.activeLinkingUnitIndex = 1u;
+    return r;
+}
+
+std::string serialize(Executable const & executable) {
+    std::string r(executable.serializeTo(nullptr, 0u), '\0');
+    executable.serializeTo(&r[0u], r.size());
+    return r;
+}
+
+bool finishesAsExpected(Parser & parser,
+                        std::string const & image,
+                        std::size_t offset)
+{
+    if (parser.feed(image.data() + offset, image.size() - offset)
+        != Parser::Status::Done)
+        return false;
+    return (parser.bytesConsumed() == image.size())
+           && (serialize(parser.executable()) == image);
+}
+
+/* Moves by construction, then destroys the moved-from parser: */
+bool moveConstructAt(std::string const & image, std::size_t offset) {
+    std::unique_ptr<Parser> source(new Parser());
+    if (offset)
+        source->feed(image.data(), offset);
+    Parser parser(std::move(*source));
+    source.reset();
+    return finishesAsExpected(parser, image, offset);
+}
+
+/* Moves by assignment, then reuses the moved-from parser for other input: */
+bool moveAssignAt(std::string const & image, std::size_t offset) {
+    Parser source;
+    if (offset)
+        source.feed(image.data(), offset);
+    Parser parser;
+    parser = std::move(source);
+    source.reset();
+    std::string const garbage(image.size(), '\xff');
+    try {
+        source.feed(garbage.data(), garbage.size());
+    } catch (...) {}
+    return finishesAsExpected(parser, image, offset);
+}
+
+} // anonymous namespace
+
+int main() {
+    bool ok = true;
+    for (std::size_t const formatVersion : { 0x0u, 0x1u }) {
+        auto const image(serialize(makeExecutable(formatVersion)));
+        for (std::size_t offset = 0u; offset < image.size(); ++offset) {
+            try {
+                if (!moveConstructAt(image, offset)) {
+                    std::cerr << "Move construction failed for version "
+                              << formatVersion << " at offset " << offset
+                              << std::endl;
+                    ok = false;
+                }
+                if (!moveAssignAt(image, offset)) {
+                    std::cerr << "Move assignment failed for version "
+                              << formatVersion << " at offset " << offset
+                              << std::endl;
+                    ok = false;
+                }
+            } catch (std::exception const & e) {
+                std::cerr << "Version " << formatVersion << " at offset "
+                          << offset << ": " << e.what() << std::endl;
+                ok = false;
+            }
+        }
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}